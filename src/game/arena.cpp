@@ -0,0 +1,54 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace game {
+    LinearArena::LinearArena(const std::size_t block_size) : m_BlockSize(block_size) {}
+
+    void *LinearArena::allocate(const std::size_t size, const std::size_t alignment) {
+        while (m_CurrentBlock < m_Blocks.size()) {
+            auto             &block   = m_Blocks[m_CurrentBlock];
+            const auto        base    = reinterpret_cast<std::uintptr_t>(block.data.get());
+            const std::size_t aligned = ((base + m_Offset + alignment - 1) & ~(alignment - 1)) - base;
+
+            if (aligned + size <= block.size) {
+                m_Offset = aligned + size;
+                m_BytesUsed += size;
+                return block.data.get() + aligned;
+            }
+
+            m_CurrentBlock++;
+            m_Offset = 0;
+        }
+
+        // oversized requests get a block of their own, which is kept around (and reused) like any other block
+        const std::size_t block_size = std::max(m_BlockSize, size + alignment);
+        m_Blocks.push_back({std::make_unique<std::byte[]>(block_size), block_size});
+        m_CurrentBlock = m_Blocks.size() - 1;
+        m_Offset       = 0;
+        return allocate(size, alignment);
+    }
+
+    void LinearArena::reset() noexcept {
+        m_CurrentBlock = 0;
+        m_Offset       = 0;
+        m_BytesUsed    = 0;
+    }
+
+    std::size_t LinearArena::get_bytes_used() const noexcept {
+        return m_BytesUsed;
+    }
+
+    std::size_t LinearArena::get_bytes_reserved() const noexcept {
+        std::size_t reserved = 0;
+        for (const auto &block : m_Blocks) {
+            reserved += block.size;
+        }
+        return reserved;
+    }
+} // namespace game
@@ -0,0 +1,67 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace game {
+    // Bump allocator handing out memory from large blocks. Nothing is freed individually; reset() makes all blocks available again at once, so
+    // after the first few frames a per-frame arena stops allocating entirely. Only meant for trivially destructible types, since destructors
+    // are never run.
+    class LinearArena {
+      public:
+        explicit LinearArena(std::size_t block_size = 64 * 1024);
+
+        LinearArena(const LinearArena &)            = delete;
+        LinearArena &operator=(const LinearArena &) = delete;
+
+        LinearArena(LinearArena &&) noexcept            = default;
+        LinearArena &operator=(LinearArena &&) noexcept = default;
+
+        void *allocate(std::size_t size, std::size_t alignment);
+
+        template <typename T, typename... Args>
+        T *create(Args &&...args) {
+            static_assert(std::is_trivially_destructible_v<T>, "arena allocations are never destroyed");
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        // copies `values` into the arena
+        template <typename T>
+        std::span<T> copy(std::span<const T> values) {
+            static_assert(std::is_trivially_copyable_v<T>, "arena arrays are copied bytewise");
+            if (values.empty()) {
+                return {};
+            }
+
+            auto *data = static_cast<T *>(allocate(values.size_bytes(), alignof(T)));
+            std::uninitialized_copy(values.begin(), values.end(), data);
+            return {data, values.size()};
+        }
+
+        // Invalidates everything allocated so far, keeping the blocks for reuse.
+        void reset() noexcept;
+
+        [[nodiscard]] std::size_t get_bytes_used() const noexcept;
+        [[nodiscard]] std::size_t get_bytes_reserved() const noexcept;
+
+      private:
+        struct Block {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t                  size;
+        };
+
+        std::vector<Block> m_Blocks;
+        std::size_t        m_BlockSize;
+        std::size_t        m_CurrentBlock = 0;
+        std::size_t        m_Offset       = 0;
+        std::size_t        m_BytesUsed    = 0;
+    };
+} // namespace game
@@ -0,0 +1,214 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/asset_pack.hpp"
+#include "game/hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace game {
+    namespace {
+        constexpr char          magic[4] = {'G', 'P', 'A', 'K'};
+        constexpr std::uint32_t version  = 1;
+
+        struct Header {
+            char          magic[4];
+            std::uint32_t version;
+            std::uint32_t entry_count;
+            std::uint32_t alignment;
+        };
+
+        static_assert(sizeof(Header) == 16);
+    } // namespace
+
+    AssetPack::AssetPack(const std::filesystem::path &path) {
+#ifdef _WIN32
+        m_File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_File == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error(std::format("Failed to open {}", path.string()));
+        }
+
+        LARGE_INTEGER size;
+        GetFileSizeEx(m_File, &size);
+        m_Size    = static_cast<std::size_t>(size.QuadPart);
+        m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_Mapping != nullptr) {
+            m_Data = static_cast<const std::uint8_t *>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (m_Data == nullptr) {
+            if (m_Mapping != nullptr) {
+                CloseHandle(m_Mapping);
+            }
+            CloseHandle(m_File);
+            throw std::runtime_error(std::format("Failed to map {}", path.string()));
+        }
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error(std::format("Failed to open {}", path.string()));
+        }
+
+        struct stat status {};
+        fstat(fd, &status);
+        m_Size = static_cast<std::size_t>(status.st_size);
+
+        // the mapping keeps the file referenced by itself
+        void *mapping = m_Size != 0 ? mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error(std::format("Failed to map {}", path.string()));
+        }
+        m_Data = static_cast<const std::uint8_t *>(mapping);
+#endif
+
+        Header header;
+        if (m_Size < sizeof(header)) {
+            unmap();
+            throw std::runtime_error(std::format("{} is not an asset pack", path.string()));
+        }
+        std::memcpy(&header, m_Data, sizeof(header));
+
+        const std::size_t index_end = sizeof(header) + static_cast<std::size_t>(header.entry_count) * sizeof(Entry);
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version || index_end > m_Size) {
+            unmap();
+            throw std::runtime_error(std::format("{} is not an asset pack of version {}", path.string(), version));
+        }
+
+        // the mapping is page aligned, so the entries right after the header are suitably aligned to be used in place
+        m_Index = {reinterpret_cast<const Entry *>(m_Data + sizeof(header)), header.entry_count};
+        for (const Entry &entry : m_Index) {
+            if (entry.offset > m_Size || entry.size > m_Size - entry.offset || entry.path_offset + std::uint64_t {entry.path_length} > m_Size) {
+                unmap();
+                throw std::runtime_error(std::format("{} is corrupted", path.string()));
+            }
+        }
+    }
+
+    AssetPack::~AssetPack() {
+        unmap();
+    }
+
+    void AssetPack::unmap() {
+        if (m_Data == nullptr) {
+            return;
+        }
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+        CloseHandle(m_File);
+#else
+        munmap(const_cast<std::uint8_t *>(m_Data), m_Size);
+#endif
+        m_Data = nullptr;
+    }
+
+    std::optional<std::span<const std::uint8_t>> AssetPack::find(const std::string_view path) const {
+        const std::uint64_t hash = fnv1a(path);
+
+        // entries with the same hash are next to each other; which of them has the path can only be told by comparing it
+        auto it = std::ranges::lower_bound(m_Index, hash, {}, &Entry::hash);
+        for (; it != m_Index.end() && it->hash == hash; ++it) {
+            const std::string_view entry_path(reinterpret_cast<const char *>(m_Data + it->path_offset), it->path_length);
+            if (entry_path == path) {
+                return std::span(m_Data + it->offset, it->size);
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool AssetPack::contains(const std::string_view path) const {
+        return find(path).has_value();
+    }
+
+    std::span<const std::uint8_t> AssetPack::get(const std::string_view path) const {
+        if (const auto data = find(path)) {
+            return *data;
+        }
+        throw std::runtime_error(std::format("Asset {} is not in the pack", path));
+    }
+
+    std::string_view AssetPack::get_text(const std::string_view path) const {
+        const auto data = get(path);
+        return {reinterpret_cast<const char *>(data.data()), data.size()};
+    }
+
+    AssetPackWriter::AssetPackWriter(const std::size_t alignment) : m_Alignment(alignment) {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw std::invalid_argument("Pack alignment must be a power of two");
+        }
+    }
+
+    void AssetPackWriter::add(std::string path, std::vector<std::uint8_t> data) {
+        if (std::ranges::any_of(m_Assets, [&](const Asset &asset) { return asset.path == path; })) {
+            throw std::invalid_argument(std::format("Asset {} was already added", path));
+        }
+        m_Assets.push_back({std::move(path), std::move(data)});
+    }
+
+    void AssetPackWriter::add_file(std::string path, const std::filesystem::path &file) {
+        std::ifstream f(file, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!f) {
+            throw std::runtime_error(std::format("Failed to open {}", file.string()));
+        }
+
+        const std::streampos      end = f.tellg();
+        std::vector<std::uint8_t> data(static_cast<std::size_t>(end));
+        f.seekg(0, std::ios::beg);
+        f.read(reinterpret_cast<char *>(data.data()), end);
+
+        add(std::move(path), std::move(data));
+    }
+
+    void AssetPackWriter::write(const std::filesystem::path &path) const {
+        std::vector<const Asset *> sorted;
+        for (const auto &asset : m_Assets) {
+            sorted.push_back(&asset);
+        }
+        std::ranges::sort(sorted, {}, [](const Asset *asset) { return fnv1a(asset->path); });
+
+        const Header header {{magic[0], magic[1], magic[2], magic[3]},
+                             version,
+                             static_cast<std::uint32_t>(sorted.size()),
+                             static_cast<std::uint32_t>(m_Alignment)};
+
+        std::vector<std::uint8_t> file(sizeof(header) + sorted.size() * sizeof(AssetPack::Entry));
+        std::memcpy(file.data(), &header, sizeof(header));
+
+        std::vector<AssetPack::Entry> index;
+        for (const Asset *asset : sorted) {
+            index.push_back(
+                {fnv1a(asset->path), 0, asset->data.size(), static_cast<std::uint32_t>(file.size()), static_cast<std::uint32_t>(asset->path.size())});
+            file.insert(file.end(), asset->path.begin(), asset->path.end());
+        }
+
+        for (std::size_t i = 0; i < sorted.size(); i++) {
+            file.resize((file.size() + m_Alignment - 1) / m_Alignment * m_Alignment);
+            index[i].offset = file.size();
+            file.insert(file.end(), sorted[i]->data.begin(), sorted[i]->data.end());
+        }
+        std::memcpy(file.data() + sizeof(header), index.data(), index.size() * sizeof(AssetPack::Entry));
+
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out) {
+            throw std::runtime_error(std::format("Failed to write {}", path.string()));
+        }
+    }
+} // namespace game
@@ -0,0 +1,85 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace game {
+    // A read-only archive of assets, memory mapped as a whole. Assets are looked up by their path within the pack ('/' separated, relative
+    // to the directory that was packed) through an index sorted by the paths' FNV-1a hashes, and handed out as views into the mapping, so
+    // nothing is copied and pages are only read in when touched. Views stay valid as long as the pack is alive.
+    //
+    // Layout, all little endian: a 16 byte header (magic "GPAK", version, entry count, payload alignment), the index entries (hash, offset,
+    // size, path offset, path length), the path strings, then the payloads, each starting at a multiple of the alignment.
+    class AssetPack {
+      public:
+        explicit AssetPack(const std::filesystem::path &path);
+        ~AssetPack();
+
+        AssetPack(const AssetPack &)            = delete;
+        AssetPack &operator=(const AssetPack &) = delete;
+
+        [[nodiscard]] std::optional<std::span<const std::uint8_t>> find(std::string_view path) const;
+        [[nodiscard]] bool                                         contains(std::string_view path) const;
+
+        // Like find, but throws when the pack has no such asset.
+        [[nodiscard]] std::span<const std::uint8_t> get(std::string_view path) const;
+        [[nodiscard]] std::string_view              get_text(std::string_view path) const;
+
+        [[nodiscard]] std::size_t get_entry_count() const noexcept { return m_Index.size(); }
+
+        // mapped size of the whole file
+        [[nodiscard]] std::size_t get_size() const noexcept { return m_Size; }
+
+      private:
+        friend class AssetPackWriter;
+
+        struct Entry {
+            std::uint64_t hash;
+            std::uint64_t offset;
+            std::uint64_t size;
+            std::uint32_t path_offset;
+            std::uint32_t path_length;
+        };
+
+        void unmap();
+
+        const std::uint8_t    *m_Data = nullptr;
+        std::size_t            m_Size = 0;
+        std::span<const Entry> m_Index;
+#ifdef _WIN32
+        void *m_File    = nullptr;
+        void *m_Mapping = nullptr;
+#endif
+    };
+
+    // Builds a pack in memory and writes it out in one go. Used by the asset packer, not at runtime.
+    class AssetPackWriter {
+      public:
+        explicit AssetPackWriter(std::size_t alignment = 64);
+
+        // Throws when `path` is already in the pack.
+        void add(std::string path, std::vector<std::uint8_t> data);
+        void add_file(std::string path, const std::filesystem::path &file);
+
+        void write(const std::filesystem::path &path) const;
+
+      private:
+        struct Asset {
+            std::string               path;
+            std::vector<std::uint8_t> data;
+        };
+
+        std::size_t        m_Alignment;
+        std::vector<Asset> m_Assets;
+    };
+} // namespace game
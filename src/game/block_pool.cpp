@@ -0,0 +1,168 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/block_pool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace game {
+    namespace {
+        // in front of every block, keeping what follows it at malloc's 16-byte alignment
+        struct alignas(16) Header {
+            std::size_t capacity; // usable bytes after the header
+            std::size_t size_class;
+        };
+
+        constexpr std::size_t unpooled  = ~std::size_t {0};
+        constexpr int         min_shift = std::bit_width(BlockPool::min_pooled_size) - 1;
+
+        static_assert(std::has_single_bit(BlockPool::min_pooled_size) && std::has_single_bit(BlockPool::max_cached_bytes));
+
+        // A quarter of the power of two below `size` is the step between classes, so rounding up wastes less than a quarter.
+        std::size_t size_class(const std::size_t size, std::size_t &capacity) {
+            const int         exponent = std::bit_width(size) - 1;
+            const std::size_t step     = std::size_t {1} << (exponent - 2);
+            capacity                   = (size + step - 1) / step * step;
+            // a capacity of a full power of two above is the first class of the next octave
+            return static_cast<std::size_t>(exponent - min_shift) * 4 + (capacity >> (exponent - 2)) - 4;
+        }
+
+        Header *header_of(void *block) {
+            return static_cast<Header *>(block) - 1;
+        }
+
+        void *allocate_block(const std::size_t capacity, const std::size_t size_class) {
+            auto *header = static_cast<Header *>(std::malloc(sizeof(Header) + capacity));
+            if (header == nullptr) {
+                return nullptr;
+            }
+            *header = {capacity, size_class};
+            return header + 1;
+        }
+
+        // set once the thread's pool is destroyed; blocks released after that (by other thread_locals going away) go straight to the system
+        thread_local bool pool_destroyed = false;
+    } // namespace
+
+    void BlockPool::Deleter::operator()(void *block) const noexcept {
+        pooled_free(block);
+    }
+
+    BlockPool &BlockPool::get() {
+        thread_local BlockPool pool;
+        return pool;
+    }
+
+    BlockPool::~BlockPool() {
+        trim();
+        pool_destroyed = true;
+    }
+
+    void *BlockPool::allocate(const std::size_t size) {
+        m_Allocations++;
+        if (size < min_pooled_size || size > max_cached_bytes) {
+            return allocate_block(size, unpooled);
+        }
+
+        std::size_t       capacity;
+        const std::size_t index = size_class(size, capacity);
+        if (auto &free = m_Free[index]; !free.empty()) {
+            void *block = free.back();
+            free.pop_back();
+            m_CachedBytes -= capacity;
+            m_Reused++;
+            return block;
+        }
+        return allocate_block(capacity, index);
+    }
+
+    void *BlockPool::reallocate(void *block, const std::size_t size) {
+        if (block == nullptr) {
+            return allocate(size);
+        }
+
+        const Header *header = header_of(block);
+        if (size <= header->capacity) {
+            return block;
+        }
+
+        void *grown = allocate(size);
+        if (grown != nullptr) {
+            std::memcpy(grown, block, header->capacity);
+            release(block);
+        }
+        return grown;
+    }
+
+    void BlockPool::release(void *block) noexcept {
+        if (block == nullptr) {
+            return;
+        }
+
+        Header *header = header_of(block);
+        if (header->size_class == unpooled || m_CachedBytes + header->capacity > max_cached_bytes) {
+            std::free(header);
+            return;
+        }
+
+        try {
+            m_Free[header->size_class].push_back(block);
+            m_CachedBytes += header->capacity;
+        } catch (const std::bad_alloc &) {
+            std::free(header);
+        }
+    }
+
+    void BlockPool::trim() noexcept {
+        for (auto &free : m_Free) {
+            for (void *block : free) {
+                std::free(header_of(block));
+            }
+            free.clear();
+        }
+        m_CachedBytes = 0;
+    }
+
+    BlockPool::Statistics BlockPool::get_statistics() const noexcept {
+        return {m_Allocations, m_Reused, m_CachedBytes};
+    }
+
+    PooledBlock allocate_pooled(const std::size_t size) {
+        void *block = BlockPool::get().allocate(size);
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        return PooledBlock(block);
+    }
+
+    void *pooled_malloc(const std::size_t size) {
+        return pool_destroyed ? allocate_block(size, unpooled) : BlockPool::get().allocate(size);
+    }
+
+    void *pooled_realloc(void *block, const std::size_t size) {
+        if (!pool_destroyed) {
+            return BlockPool::get().reallocate(block, size);
+        }
+
+        void *grown = allocate_block(size, unpooled);
+        if (grown != nullptr && block != nullptr) {
+            std::memcpy(grown, block, std::min(size, header_of(block)->capacity));
+            std::free(header_of(block));
+        }
+        return grown;
+    }
+
+    void pooled_free(void *block) {
+        if (pool_destroyed) {
+            if (block != nullptr) {
+                std::free(header_of(block));
+            }
+            return;
+        }
+        BlockPool::get().release(block);
+    }
+} // namespace game
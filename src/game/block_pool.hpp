@@ -0,0 +1,77 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace game {
+    // Recycles the large, short-lived blocks image decoding goes through (stb's output and scratch buffers, converted images), so that loading
+    // one image after another reuses memory instead of asking the system for fresh megabytes each time. Blocks between `min_pooled_size` and
+    // `max_cached_bytes` are rounded up to size classes a quarter octave apart and kept for reuse when released, all others go straight to
+    // malloc and free. Each thread has its own pool; a block may be released on any thread and then joins that thread's pool. A pool keeps at
+    // most `max_cached_bytes` around.
+    class BlockPool {
+      public:
+        struct Deleter {
+            void operator()(void *block) const noexcept;
+        };
+
+        struct Statistics {
+            std::size_t allocations;
+            std::size_t reused; // allocations served from the cache
+            std::size_t cached_bytes;
+        };
+
+        static constexpr std::size_t min_pooled_size  = 64 * 1024;
+        static constexpr std::size_t max_cached_bytes = 128 * 1024 * 1024;
+
+        // the calling thread's pool
+        static BlockPool &get();
+
+        ~BlockPool();
+
+        BlockPool(const BlockPool &)            = delete;
+        BlockPool &operator=(const BlockPool &) = delete;
+
+        // malloc-like: 16-byte aligned, nullptr when out of memory. Blocks must be released through a pool, never passed to free().
+        [[nodiscard]] void *allocate(std::size_t size);
+        // keeps the block when it's large enough already
+        [[nodiscard]] void *reallocate(void *block, std::size_t size);
+        void                release(void *block) noexcept;
+
+        // Hands every cached block back to the system.
+        void trim() noexcept;
+
+        [[nodiscard]] Statistics get_statistics() const noexcept;
+
+      private:
+        // four per power of two from min_pooled_size up to max_cached_bytes
+        static constexpr std::size_t class_count = (std::bit_width(max_cached_bytes) - std::bit_width(min_pooled_size)) * 4 + 1;
+
+        BlockPool() = default;
+
+        // released blocks by size class
+        std::array<std::vector<void *>, class_count> m_Free;
+        std::size_t                                  m_CachedBytes = 0;
+        std::size_t                                  m_Allocations = 0;
+        std::size_t                                  m_Reused      = 0;
+    };
+
+    // An owned block from the calling thread's pool.
+    using PooledBlock = std::unique_ptr<void, BlockPool::Deleter>;
+
+    // Like BlockPool::get().allocate(), but throws std::bad_alloc instead of returning nullptr.
+    PooledBlock allocate_pooled(std::size_t size);
+
+    // malloc/realloc/free replacements for C libraries (stb's STBI_MALLOC and friends), going through the calling thread's pool. Safe to call
+    // while the thread shuts down, when its pool may already be gone.
+    void *pooled_malloc(std::size_t size);
+    void *pooled_realloc(void *block, std::size_t size);
+    void  pooled_free(void *block);
+} // namespace game
@@ -4,6 +4,8 @@
 
 // ReSharper disable CppMemberFunctionMayBeConst
 #include "game/game.hpp"
+#include "game/render/resource_cache.hpp"
+#include "game/render/state_cache.hpp"
 #include <glad/gl.h>
 
 #include <iostream>
@@ -24,7 +26,9 @@ namespace game {
         glfwWindowHint(GLFW_CONTEXT_DEBUG, true);
         glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, true);
         glfwWindowHint(GLFW_RESIZABLE, false);
-        glfwWindowHint(GLFW_SAMPLES, 8);
+        // the window only ever gets a full screen copy of the final image, which multisampling does nothing for; offscreen targets pick
+        // their own sample count (RenderTarget::Description::samples) and are resolved explicitly
+        glfwWindowHint(GLFW_SAMPLES, 0);
 
         m_Window = glfwCreateWindow(640, 480, "Game", nullptr, nullptr);
         glfwMakeContextCurrent(m_Window);
@@ -37,13 +41,13 @@ namespace game {
             },
             nullptr);
         glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, false);
-
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glBlendEquation(GL_FUNC_ADD);
     }
 
-    Game::~Game() {}
+    Game::~Game() {
+        // cached samplers and pipelines would otherwise outlive the context
+        render::PipelineCache::get().clear();
+        render::SamplerCache::get().clear();
+    }
 
     void Game::mainloop() {
         create();
@@ -96,62 +100,152 @@ namespace game {
         m_VertexArray  = std::make_shared<render::VertexArray>();
         m_VertexArray->add_vertex_buffer(m_VertexBuffer.get(), {2, 2});
 
-        m_ScreenVertexBuffer = std::make_shared<render::Buffer>(sizeof(vertices), vertices);
+        m_ScreenVertexBuffer = std::make_shared<render::Buffer>(sizeof(screen_vertices), screen_vertices);
         m_ScreenVertexArray  = std::make_shared<render::VertexArray>();
         m_ScreenVertexArray->add_vertex_buffer(m_ScreenVertexBuffer.get(), {2, 2});
 
-        m_Texture = render::Texture::load("assets/test.png");
-
-        int width,height;
-        glfwGetFramebufferSize(m_Window, &width, &height);
+        // created here rather than in the constructor as its staging buffer needs the context
+        m_TextureLoader    = std::make_unique<render::TextureLoader>(m_ThreadPool);
+        // budget for textures loaded through the residency manager; beyond it, the least recently drawn ones give up their top mip levels
+        m_TextureResidency = std::make_unique<render::TextureResidency>(*m_TextureLoader, 256 * 1024 * 1024);
+
+        using Type = render::ShaderModule::Type;
+        // programs shared with anything else loading the same sources
+        auto &programs = render::ResourceCache::get();
+
+        // a packed build ships assets.pack (made by asset_packer from the assets directory), otherwise the loose files are used
+        if (std::filesystem::exists("assets.pack")) {
+            m_Assets        = std::make_unique<AssetPack>("assets.pack");
+            m_Texture       = m_TextureResidency->load(*m_Assets, "test.png");
+            m_ShaderProgram = programs.load_program(*m_Assets, {{Type::Vertex, "main.vert"}, {Type::Fragment, "main.frag"}});
+            m_PostProcess   = programs.load_program(*m_Assets, {{Type::Vertex, "post_process.vert"}, {Type::Fragment, "post_process.frag"}});
+            m_PostProcess2  = programs.load_program(*m_Assets, {{Type::Compute, "post_process2.comp"}});
+        } else {
+            m_Texture       = m_TextureResidency->load("assets/test.png");
+            m_ShaderProgram = programs.load_program({{Type::Vertex, "assets/main.vert"}, {Type::Fragment, "assets/main.frag"}});
+            m_PostProcess   = programs.load_program({{Type::Vertex, "assets/post_process.vert"}, {Type::Fragment, "assets/post_process.frag"}});
+            m_PostProcess2  = programs.load_program({{Type::Compute, "assets/post_process2.comp"}});
+        }
 
-        // build render target
-        m_RenderTargetTexture = render::Texture::create_2d(width, height, render::Format::RGBA8);
-        m_RenderTargetDepthStencilBuffer = std::make_shared<render::RenderBuffer>(width, height, render::Format::D24S8);
-        m_RenderTarget = std::make_shared<render::Framebuffer>();
-        m_RenderTarget->color_attachment(m_RenderTargetTexture.get(), 0);
-        m_RenderTarget->attachment(m_RenderTargetDepthStencilBuffer.get(), render::Framebuffer::Attachment::DepthStencil);
-        glTextureParameteri(m_RenderTargetTexture->get_handle(), GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        m_RenderTargetTexture2 = render::Texture::create_2d(width, height, render::Format::RGBA8);
-        m_RenderTargetDepthStencilBuffer2 = std::make_shared<render::RenderBuffer>(width, height, render::Format::D24S8);
-        m_RenderTarget2 = std::make_shared<render::Framebuffer>();
-        m_RenderTarget2->color_attachment(m_RenderTargetTexture2.get(), 0);
-        m_RenderTarget2->attachment(m_RenderTargetDepthStencilBuffer2.get(), render::Framebuffer::Attachment::DepthStencil);
-        glTextureParameteri(m_RenderTargetTexture2->get_handle(), GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        m_ShaderProgram = render::ShaderProgram::load("assets/main.vert", "assets/main.frag");
-        m_PostProcess = render::ShaderProgram::load("assets/post_process.vert", "assets/post_process.frag");
-        m_PostProcess2 = render::ShaderProgram::load_compute("assets/post_process2.comp");
+        m_ShaderProgram->uniform1i("uTexture", 0);
+        m_PostProcess->uniform1i("uTexture", 0);
+        m_PostProcess2->uniform1i("uPostProcessingSource", 0);
+        m_PostProcessOffsetLocation = m_PostProcess->get_uniform_location("uOffset");
+
+        // the sprite is blended over the scene, full screen passes overwrite their target
+        const render::VertexLayout quad_layout {{{2, 2}}};
+        m_SpritePipeline      = render::Pipeline::create({.program       = m_ShaderProgram,
+                                                          .vertex_layout = quad_layout,
+                                                          .blend         = render::BlendState::alpha_blending()});
+        m_PostProcessPipeline = render::Pipeline::create({.program = m_PostProcess, .vertex_layout = quad_layout});
+        m_PresentPipeline     = render::Pipeline::create({.program = m_ShaderProgram, .vertex_layout = quad_layout});
+
+        create_render_graph();
     }
 
-    void Game::render(float delta) {
-        render::clearBackground({1.0f, 0.0f, 0.0f});
+    void Game::create_render_graph() {
+        using Graph = render::RenderGraph;
 
-        m_RenderTarget->bind();
-
-        m_ShaderProgram->use();
-        m_Texture->bind_unit(0);
-        m_ShaderProgram->uniform1i("uTexture", 0);
-        m_VertexArray->bind();
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        int width, height;
+        glfwGetFramebufferSize(m_Window, &width, &height);
 
-        m_RenderTarget2->bind();
+        const render::TextureDescription color {static_cast<unsigned int>(width), static_cast<unsigned int>(height), render::Format::RGBA8};
+        const render::TextureDescription depth_stencil {color.width, color.height, render::Format::D24S8};
+        const auto                       linear = render::SamplerDescription::linear(render::WrapMode::ClampToBorder);
+
+        const auto backbuffer = m_RenderGraph.import_backbuffer("backbuffer", color.width, color.height);
+
+        Graph::ResourceHandle scene;
+        m_RenderGraph.add_pass(
+            "scene",
+            [&](Graph::PassBuilder &builder) {
+                scene = builder.create("scene", color);
+                builder.write(scene, Graph::WriteUsage::ColorAttachment);
+                builder.clear(scene, {.color = {1.0f, 0.0f, 0.0f, 1.0f}});
+                // only ever written, so the graph invalidates it on both ends instead of clearing and storing it
+                builder.write(builder.create("scene_depth", depth_stencil), Graph::WriteUsage::DepthStencilAttachment);
+            },
+            [this](const Graph::PassContext &context) {
+                // sampler uniforms never change, so they're set once in create() rather than recorded into every command
+                const render::Texture *textures[] = {m_Texture.get()};
+                m_TextureResidency->touch(*m_Texture);
+                m_RenderQueue.submit(0,
+                                     0.0f,
+                                     {.pipeline     = m_SpritePipeline.get(),
+                                      .vertex_array = m_VertexArray.get(),
+                                      .framebuffer  = context.get_framebuffer(),
+                                      .textures     = textures,
+                                      .count        = 6});
+                m_RenderQueue.execute();
+                m_RenderQueue.reset();
+            });
+
+        Graph::ResourceHandle chromatic;
+        m_RenderGraph.add_pass(
+            "chromatic_aberration",
+            [&](Graph::PassBuilder &builder) {
+                builder.sample(scene, linear);
+                chromatic = builder.create("chromatic_aberration", color);
+                builder.write(chromatic, Graph::WriteUsage::ColorAttachment);
+            },
+            [this, scene](const Graph::PassContext &context) {
+                const render::Texture     *textures[] = {context.get_texture(scene)};
+                const render::UniformValue uniforms[] = {
+                    render::UniformValue::of(m_PostProcessOffsetLocation, static_cast<float>(sin(m_ThisFrame / 5.0f) * 0.1f)),
+                };
+                m_RenderQueue.submit(0,
+                                     0.0f,
+                                     {.pipeline     = m_PostProcessPipeline.get(),
+                                      .vertex_array = m_ScreenVertexArray.get(),
+                                      .framebuffer  = context.get_framebuffer(),
+                                      .textures     = textures,
+                                      .uniforms     = uniforms,
+                                      .count        = 6});
+                m_RenderQueue.execute();
+                m_RenderQueue.reset();
+            });
+
+        // written through image stores, so this pass needs no framebuffer; it ends up aliasing the scene texture
+        Graph::ResourceHandle blurred;
+        m_RenderGraph.add_pass(
+            "blur",
+            [&](Graph::PassBuilder &builder) {
+                builder.read(chromatic);
+                blurred = builder.create("blurred", color);
+                builder.write(blurred, Graph::WriteUsage::Image);
+            },
+            [this, chromatic, blurred](const Graph::PassContext &context) {
+                context.get_texture(chromatic)->bind_unit(0);
+                context.get_texture(blurred)->bind_image(0, render::ShaderAccess::WriteOnly, render::Format::RGBA8);
+                m_PostProcess2->dispatch((context.get_width() + 15) / 16, (context.get_height() + 15) / 16, 1);
+            });
+
+        m_RenderGraph.add_pass(
+            "present",
+            [&](Graph::PassBuilder &builder) {
+                builder.sample(blurred, linear);
+                builder.write(backbuffer, Graph::WriteUsage::ColorAttachment);
+            },
+            [this, blurred](const Graph::PassContext &context) {
+                const render::Texture *textures[] = {context.get_texture(blurred)};
+                m_RenderQueue.submit(0,
+                                     0.0f,
+                                     {.pipeline     = m_PresentPipeline.get(),
+                                      .vertex_array = m_ScreenVertexArray.get(),
+                                      .textures     = textures,
+                                      .count        = 6});
+                m_RenderQueue.execute();
+                m_RenderQueue.reset();
+            });
+
+        m_RenderGraph.compile();
+    }
 
-        m_PostProcess->use();
-        m_RenderTargetTexture->bind_unit(0);
-        m_PostProcess->uniform1i("uTexture", 0);
-        m_PostProcess->uniform1f("uOffset", sin(m_ThisFrame / 5.0f) * 0.1f);
-        m_VertexArray->bind();
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    void Game::render(float delta) {
+        m_TextureResidency->update();
+        m_TextureLoader->update(std::chrono::milliseconds(2));
 
-        render::Framebuffer::bind_default();
-        m_PostProcess2->use();
-        m_RenderTargetTexture2->bind_unit(0);
-        m_PostProcess->uniform1i("uTexture", 0);
-        m_VertexArray->bind();
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        m_RenderGraph.execute();
     }
 
-
 } // namespace game
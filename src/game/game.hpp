@@ -1,6 +1,13 @@
 #pragma once
 
+#include "game/asset_pack.hpp"
+#include "game/render/pipeline.hpp"
 #include "game/render/render.hpp"
+#include "game/render/render_graph.hpp"
+#include "game/render/render_queue.hpp"
+#include "game/render/texture_loader.hpp"
+#include "game/render/texture_residency.hpp"
+#include "game/thread_pool.hpp"
 #include <GLFW/glfw3.h>
 
 #include <memory>
@@ -25,12 +32,20 @@ namespace game {
         void render(float delta);
 
       private:
+        void create_render_graph();
+
         GLFWwindow *m_Window;
 
         float m_DeltaTime;
         float m_LastFrame;
         float m_ThisFrame;
 
+        // declared before anything using them, so they outlive them
+        ThreadPool                                m_ThreadPool;
+        std::unique_ptr<AssetPack>                m_Assets;
+        std::unique_ptr<render::TextureLoader>    m_TextureLoader;
+        std::unique_ptr<render::TextureResidency> m_TextureResidency;
+
         std::shared_ptr<render::Buffer>      m_VertexBuffer;
         std::shared_ptr<render::VertexArray> m_VertexArray;
 
@@ -41,16 +56,16 @@ namespace game {
 
         std::shared_ptr<render::Texture> m_Texture;
 
-        std::shared_ptr<render::Texture>      m_RenderTargetTexture;
-        std::shared_ptr<render::RenderBuffer> m_RenderTargetDepthStencilBuffer;
-        std::shared_ptr<render::Framebuffer>  m_RenderTarget;
-
-        std::shared_ptr<render::Texture>      m_RenderTargetTexture2;
-        std::shared_ptr<render::RenderBuffer> m_RenderTargetDepthStencilBuffer2;
-        std::shared_ptr<render::Framebuffer>  m_RenderTarget2;
-
         std::shared_ptr<render::ShaderProgram> m_PostProcess;
         std::shared_ptr<render::ShaderProgram> m_PostProcess2;
+        int                                    m_PostProcessOffsetLocation;
+
+        std::shared_ptr<const render::Pipeline> m_SpritePipeline;
+        std::shared_ptr<const render::Pipeline> m_PostProcessPipeline;
+        std::shared_ptr<const render::Pipeline> m_PresentPipeline;
+
+        render::RenderQueue m_RenderQueue;
+        render::RenderGraph m_RenderGraph;
     };
 
 } // namespace game
@@ -0,0 +1,53 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string_view>
+
+namespace game {
+    // boost-style hash mixing, for hashing aggregates field by field
+    template <typename T>
+    void hash_combine(std::size_t &seed, const T &value) {
+        seed ^= std::hash<T>()(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
+    // 64-bit FNV-1a, for hashes that end up in files and so must not change between builds or platforms like std::hash may
+    constexpr std::uint64_t fnv1a(const std::string_view text) {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (const char c : text) {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // Content hash of a whole file, eight bytes per multiply rather than fnv1a's one. Not for anything stored, as it depends on endianness.
+    inline std::uint64_t hash_bytes(const std::span<const std::uint8_t> bytes) {
+        constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+
+        std::uint64_t hash = bytes.size() * multiplier;
+        std::size_t   i    = 0;
+        for (; i + 8 <= bytes.size(); i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            hash = (std::rotl(hash, 5) ^ word) * multiplier;
+        }
+        for (; i < bytes.size(); i++) {
+            hash = (std::rotl(hash, 5) ^ bytes[i]) * multiplier;
+        }
+
+        // the multiplies only carry upwards, so the low bits need mixing in from the top before they are used to pick buckets
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+} // namespace game
@@ -0,0 +1,327 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/image/bc_encoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GAME_IMAGE_SSE2 1
+#endif
+
+namespace game::image {
+    bool can_compress(const BlockFormat format) {
+        switch (format) {
+        case BlockFormat::BC1:
+        case BlockFormat::BC1_SRGB:
+        case BlockFormat::BC3:
+        case BlockFormat::BC3_SRGB:
+        case BlockFormat::BC4:
+        case BlockFormat::BC5:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    namespace {
+        // 4x4 RGBA8 texels, rows one after another
+        using Block = std::array<std::uint8_t, 64>;
+
+        void fetch_block(const std::uint8_t *source,
+                         const unsigned int  width,
+                         const unsigned int  height,
+                         const unsigned int  bx,
+                         const unsigned int  by,
+                         Block              &block) {
+            for (unsigned int y = 0; y < 4; y++) {
+                const unsigned int  sy  = std::min(by * 4 + y, height - 1);
+                const std::uint8_t *row = source + static_cast<std::size_t>(sy) * width * 4;
+                for (unsigned int x = 0; x < 4; x++) {
+                    const unsigned int sx = std::min(bx * 4 + x, width - 1);
+                    std::memcpy(block.data() + (y * 4 + x) * 4, row + sx * 4, 4);
+                }
+            }
+        }
+
+        void store_u16(std::uint8_t *out, const std::uint16_t value) {
+            out[0] = static_cast<std::uint8_t>(value);
+            out[1] = static_cast<std::uint8_t>(value >> 8);
+        }
+
+        void store_u32(std::uint8_t *out, const std::uint32_t value) {
+            for (unsigned int i = 0; i < 4; i++) {
+                out[i] = static_cast<std::uint8_t>(value >> i * 8);
+            }
+        }
+
+        std::uint16_t to_565(const int r, const int g, const int b) {
+            return static_cast<std::uint16_t>((r * 31 + 127) / 255 << 11 | (g * 63 + 127) / 255 << 5 | (b * 31 + 127) / 255);
+        }
+
+        // the 8-bit color a decoder expands a 565 endpoint to
+        std::array<int, 3> from_565(const std::uint16_t color) {
+            const int r = color >> 11 & 31;
+            const int g = color >> 5 & 63;
+            const int b = color & 31;
+            return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+        }
+
+        void channel_bounds(const Block &block, std::array<int, 3> &low, std::array<int, 3> &high) {
+#ifdef GAME_IMAGE_SSE2
+            const auto *rows = reinterpret_cast<const __m128i *>(block.data());
+            __m128i     min  = _mm_min_epu8(_mm_min_epu8(_mm_loadu_si128(rows), _mm_loadu_si128(rows + 1)),
+                                       _mm_min_epu8(_mm_loadu_si128(rows + 2), _mm_loadu_si128(rows + 3)));
+            __m128i     max  = _mm_max_epu8(_mm_max_epu8(_mm_loadu_si128(rows), _mm_loadu_si128(rows + 1)),
+                                       _mm_max_epu8(_mm_loadu_si128(rows + 2), _mm_loadu_si128(rows + 3)));
+
+            // fold the four texels of each register onto the first
+            min = _mm_min_epu8(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+            min = _mm_min_epu8(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(2, 3, 0, 1)));
+            max = _mm_max_epu8(max, _mm_shuffle_epi32(max, _MM_SHUFFLE(1, 0, 3, 2)));
+            max = _mm_max_epu8(max, _mm_shuffle_epi32(max, _MM_SHUFFLE(2, 3, 0, 1)));
+
+            const auto min_texel = static_cast<std::uint32_t>(_mm_cvtsi128_si32(min));
+            const auto max_texel = static_cast<std::uint32_t>(_mm_cvtsi128_si32(max));
+            for (unsigned int c = 0; c < 3; c++) {
+                low[c]  = static_cast<int>(min_texel >> c * 8 & 0xff);
+                high[c] = static_cast<int>(max_texel >> c * 8 & 0xff);
+            }
+#else
+            low  = {255, 255, 255};
+            high = {0, 0, 0};
+            for (unsigned int i = 0; i < 16; i++) {
+                for (unsigned int c = 0; c < 3; c++) {
+                    low[c]  = std::min<int>(low[c], block[i * 4 + c]);
+                    high[c] = std::max<int>(high[c], block[i * 4 + c]);
+                }
+            }
+#endif
+        }
+
+        // The bounding box always spans from its low to its high corner. When a channel falls while the one with the largest range rises,
+        // the colors lie along another diagonal of the box, which is picked by swapping the bounds of that channel.
+        void select_diagonal(const Block &block, std::array<int, 3> &low, std::array<int, 3> &high) {
+            unsigned int axis = 0;
+            for (unsigned int c = 1; c < 3; c++) {
+                if (high[c] - low[c] > high[axis] - low[axis]) {
+                    axis = c;
+                }
+            }
+
+            for (unsigned int c = 0; c < 3; c++) {
+                if (c == axis) {
+                    continue;
+                }
+
+                int covariance = 0;
+                for (unsigned int i = 0; i < 16; i++) {
+                    covariance += (block[i * 4 + axis] * 2 - low[axis] - high[axis]) * (block[i * 4 + c] * 2 - low[c] - high[c]);
+                }
+                if (covariance < 0) {
+                    std::swap(low[c], high[c]);
+                }
+            }
+        }
+
+#ifdef GAME_IMAGE_SSE2
+        // squared RGB distances of four texels (alpha cleared) to one color, 32 bits each
+        __m128i distances_sse2(const __m128i texels, const __m128i color) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i diff = _mm_or_si128(_mm_subs_epu8(texels, color), _mm_subs_epu8(color, texels));
+
+            // r*r + g*g and b*b + a*a of each texel
+            __m128i low  = _mm_unpacklo_epi8(diff, zero);
+            __m128i high = _mm_unpackhi_epi8(diff, zero);
+            low          = _mm_madd_epi16(low, low);
+            high         = _mm_madd_epi16(high, high);
+
+            // add the pairs, leaving each texel's sum in an even lane
+            low  = _mm_add_epi32(low, _mm_srli_epi64(low, 32));
+            high = _mm_add_epi32(high, _mm_srli_epi64(high, 32));
+            return _mm_unpacklo_epi64(_mm_shuffle_epi32(low, _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+
+        std::uint32_t color_indices(const Block &block, const std::array<std::array<int, 3>, 4> &palette) {
+            __m128i colors[4];
+            for (unsigned int i = 0; i < 4; i++) {
+                colors[i] = _mm_set1_epi32(palette[i][0] | palette[i][1] << 8 | palette[i][2] << 16);
+            }
+
+            const __m128i rgb_mask  = _mm_set1_epi32(0x00ffffff);
+            const __m128i positions = _mm_set_epi32(64, 16, 4, 1);
+            std::uint32_t indices   = 0;
+            for (unsigned int row = 0; row < 4; row++) {
+                const __m128i texels = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block.data()) + row), rgb_mask);
+
+                __m128i best  = distances_sse2(texels, colors[0]);
+                __m128i index = _mm_setzero_si128();
+                for (int i = 1; i < 4; i++) {
+                    const __m128i distance = distances_sse2(texels, colors[i]);
+                    const __m128i closer   = _mm_cmplt_epi32(distance, best);
+                    best                   = _mm_or_si128(_mm_and_si128(closer, distance), _mm_andnot_si128(closer, best));
+                    index                  = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(i)), _mm_andnot_si128(closer, index));
+                }
+
+                // shift each texel's index to its place within the row's byte, then gather the four of them
+                index = _mm_madd_epi16(index, positions);
+                index = _mm_or_si128(index, _mm_srli_si128(index, 8));
+                index = _mm_or_si128(index, _mm_srli_si128(index, 4));
+                indices |= static_cast<std::uint32_t>(_mm_cvtsi128_si32(index)) << row * 8;
+            }
+            return indices;
+        }
+#else
+        std::uint32_t color_indices(const Block &block, const std::array<std::array<int, 3>, 4> &palette) {
+            std::uint32_t indices = 0;
+            for (unsigned int i = 0; i < 16; i++) {
+                int          best  = 0x7fffffff;
+                unsigned int index = 0;
+                for (unsigned int p = 0; p < 4; p++) {
+                    int distance = 0;
+                    for (unsigned int c = 0; c < 3; c++) {
+                        const int d = block[i * 4 + c] - palette[p][c];
+                        distance += d * d;
+                    }
+                    if (distance < best) {
+                        best  = distance;
+                        index = p;
+                    }
+                }
+                indices |= index << i * 2;
+            }
+            return indices;
+        }
+#endif
+
+        // always in four-color mode, which is the only one BC3's color block has
+        void encode_color_block(const Block &block, std::uint8_t *out) {
+            std::array<int, 3> low, high;
+            channel_bounds(block, low, high);
+            select_diagonal(block, low, high);
+
+            // pull the endpoints in by 1/16 of the range, since the extremes are rarely worth representing exactly at the expense of the rest
+            for (unsigned int c = 0; c < 3; c++) {
+                const int inset = (high[c] - low[c]) / 16;
+                low[c] += inset;
+                high[c] -= inset;
+            }
+
+            std::uint16_t color0 = to_565(high[0], high[1], high[2]);
+            std::uint16_t color1 = to_565(low[0], low[1], low[2]);
+            if (color0 == color1) {
+                store_u16(out, color0);
+                store_u16(out + 2, color1);
+                store_u32(out + 4, 0);
+                return;
+            }
+            if (color0 < color1) {
+                std::swap(color0, color1);
+            }
+
+            const auto end0 = from_565(color0);
+            const auto end1 = from_565(color1);
+
+            std::array<std::array<int, 3>, 4> palette {end0, end1};
+            for (unsigned int c = 0; c < 3; c++) {
+                palette[2][c] = (end0[c] * 2 + end1[c]) / 3;
+                palette[3][c] = (end0[c] + end1[c] * 2) / 3;
+            }
+
+            store_u16(out, color0);
+            store_u16(out + 2, color1);
+            store_u32(out + 4, color_indices(block, palette));
+        }
+
+        // BC4's single channel block, also BC3's alpha and each half of BC5
+        void encode_channel_block(const Block &block, const unsigned int channel, std::uint8_t *out) {
+            int high = 0, low = 255;
+            for (unsigned int i = 0; i < 16; i++) {
+                high = std::max<int>(high, block[i * 4 + channel]);
+                low  = std::min<int>(low, block[i * 4 + channel]);
+            }
+
+            out[0] = static_cast<std::uint8_t>(high);
+            out[1] = static_cast<std::uint8_t>(low);
+
+            // eight-value mode: endpoint 0 is the maximum, 1 the minimum and 2 to 7 step from the maximum to the minimum
+            std::uint64_t indices = 0;
+            if (high != low) {
+                const int range = high - low;
+                for (unsigned int i = 0; i < 16; i++) {
+                    const int     step  = ((block[i * 4 + channel] - low) * 14 + range) / (range * 2); // 0 at the minimum, 7 at the maximum
+                    std::uint64_t index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+                    indices |= index << i * 3;
+                }
+            }
+
+            for (unsigned int i = 0; i < 6; i++) {
+                out[2 + i] = static_cast<std::uint8_t>(indices >> i * 8);
+            }
+        }
+
+        void encode_block(const BlockFormat format, const Block &block, std::uint8_t *out) {
+            switch (format) {
+            case BlockFormat::BC1:
+            case BlockFormat::BC1_SRGB:
+                encode_color_block(block, out);
+                break;
+            case BlockFormat::BC3:
+            case BlockFormat::BC3_SRGB:
+                encode_channel_block(block, 3, out);
+                encode_color_block(block, out + 8);
+                break;
+            case BlockFormat::BC4:
+                encode_channel_block(block, 0, out);
+                break;
+            case BlockFormat::BC5:
+                encode_channel_block(block, 0, out);
+                encode_channel_block(block, 1, out + 8);
+                break;
+            default:
+                throw std::invalid_argument("Unsupported block format");
+            }
+        }
+    } // namespace
+
+    void compress_rgba8(const BlockFormat                   format,
+                        const std::span<const std::uint8_t> source,
+                        const unsigned int                  width,
+                        const unsigned int                  height,
+                        const std::span<std::uint8_t>       destination) {
+        compress_rgba8_rows(format, source, width, height, destination, 0, (height + 3) / 4);
+    }
+
+    void compress_rgba8_rows(const BlockFormat                   format,
+                             const std::span<const std::uint8_t> source,
+                             const unsigned int                  width,
+                             const unsigned int                  height,
+                             const std::span<std::uint8_t>       destination,
+                             const unsigned int                  first_row,
+                             const unsigned int                  row_count) {
+        if (!can_compress(format)) {
+            throw std::invalid_argument("Unsupported block format");
+        }
+        if (source.size() < static_cast<std::size_t>(width) * height * 4 || destination.size() < compressed_size(format, width, height)) {
+            throw std::invalid_argument("Image buffer too small for its size");
+        }
+
+        const unsigned int blocks_x = (width + 3) / 4;
+        const unsigned int last_row = std::min(first_row + row_count, (height + 3) / 4);
+        const std::size_t  size     = block_size(format);
+
+        Block block;
+        for (unsigned int by = first_row; by < last_row; by++) {
+            for (unsigned int bx = 0; bx < blocks_x; bx++) {
+                fetch_block(source.data(), width, height, bx, by, block);
+                encode_block(format, block, destination.data() + (static_cast<std::size_t>(by) * blocks_x + bx) * size);
+            }
+        }
+    }
+} // namespace game::image
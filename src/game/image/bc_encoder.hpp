@@ -0,0 +1,32 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/image/dds.hpp"
+
+#include <cstdint>
+#include <span>
+
+namespace game::image {
+    // Whether compress_rgba8 can produce `format`: BC1, BC3, BC4 and BC5 (unsigned, including the sRGB variants).
+    bool can_compress(BlockFormat format);
+
+    // Compresses a tightly packed RGBA8 image. Endpoints come from the (inset) bounding box of each block rather than a least-squares fit,
+    // which is fast enough to cook every asset on each build at the cost of some quality on blocks with several distinct hues. BC1 is always
+    // opaque, BC4 takes the red channel and BC5 red and green. Blocks hanging over the right or top edge repeat the last column or row.
+    // `destination` must hold compressed_size(format, width, height) bytes.
+    void compress_rgba8(
+        BlockFormat format, std::span<const std::uint8_t> source, unsigned int width, unsigned int height, std::span<std::uint8_t> destination);
+
+    // Same as compress_rgba8, but only for the block rows [first_row, first_row + row_count). They're written at their place within
+    // `destination`, so disjoint row ranges of one image can be compressed on different threads.
+    void compress_rgba8_rows(BlockFormat                   format,
+                             std::span<const std::uint8_t> source,
+                             unsigned int                  width,
+                             unsigned int                  height,
+                             std::span<std::uint8_t>       destination,
+                             unsigned int                  first_row,
+                             unsigned int                  row_count);
+} // namespace game::image
@@ -0,0 +1,269 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/image/dds.hpp"
+#include "game/image/image_ops.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace game::image {
+    std::size_t block_size(const BlockFormat format) {
+        switch (format) {
+        case BlockFormat::BC1:
+        case BlockFormat::BC1_SRGB:
+        case BlockFormat::BC4:
+        case BlockFormat::BC4_SNORM:
+            return 8;
+        default:
+            return 16;
+        }
+    }
+
+    std::size_t compressed_size(const BlockFormat format, const unsigned int width, const unsigned int height) {
+        return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * block_size(format);
+    }
+
+    std::size_t CompressedImage::level_offset(const unsigned int level) const {
+        std::size_t offset = 0;
+        for (unsigned int i = 0; i < level; i++) {
+            offset += level_size(i);
+        }
+        return offset;
+    }
+
+    std::size_t CompressedImage::level_size(const unsigned int level) const {
+        return compressed_size(format, mip_extent(width, level), mip_extent(height, level));
+    }
+
+    namespace {
+        constexpr std::uint32_t fourcc(const char (&code)[5]) {
+            return static_cast<std::uint32_t>(code[0]) | static_cast<std::uint32_t>(code[1]) << 8 | static_cast<std::uint32_t>(code[2]) << 16 |
+                   static_cast<std::uint32_t>(code[3]) << 24;
+        }
+
+        // layout of the file: magic, DDS_HEADER (124 bytes), optionally DDS_HEADER_DXT10 (20 bytes), data
+        constexpr std::size_t header_offset      = 4;
+        constexpr std::size_t header_size        = 124;
+        constexpr std::size_t dx10_header_offset = header_offset + header_size;
+        constexpr std::size_t dx10_header_size   = 20;
+
+        // field offsets within DDS_HEADER
+        constexpr std::size_t flags_field       = 4;
+        constexpr std::size_t height_field      = 8;
+        constexpr std::size_t width_field       = 12;
+        constexpr std::size_t linear_size_field = 16;
+        constexpr std::size_t depth_field       = 20;
+        constexpr std::size_t mip_count_field   = 24;
+        constexpr std::size_t pixel_size_field  = 72;
+        constexpr std::size_t pixel_flags_field = 76;
+        constexpr std::size_t fourcc_field      = 80;
+        constexpr std::size_t caps_field        = 104;
+        constexpr std::size_t caps2_field       = 108;
+
+        constexpr std::uint32_t flags_required = 0x1 | 0x2 | 0x4 | 0x1000; // caps, height, width, pixel format
+        constexpr std::uint32_t flag_linear    = 0x80000;
+        constexpr std::uint32_t flag_mip_count = 0x20000;
+        constexpr std::uint32_t flag_depth     = 0x800000;
+        constexpr std::uint32_t pixel_fourcc   = 0x4;
+        constexpr std::uint32_t caps_texture   = 0x1000;
+        constexpr std::uint32_t caps_mipmap    = 0x8 | 0x400000; // complex, mipmap
+        constexpr std::uint32_t caps2_cube_map = 0x200;
+        constexpr std::uint32_t caps2_volume   = 0x200000;
+
+        constexpr std::uint32_t dimension_texture_2d = 3;
+        constexpr std::uint32_t misc_texture_cube    = 0x4;
+
+        std::uint32_t read_u32(const std::span<const std::uint8_t> file, const std::size_t offset) {
+            // DDS is little endian, as is everything the game runs on
+            std::uint32_t value;
+            std::memcpy(&value, file.data() + offset, sizeof(value));
+            return value;
+        }
+
+        void write_u32(const std::span<std::uint8_t> file, const std::size_t offset, const std::uint32_t value) {
+            std::memcpy(file.data() + offset, &value, sizeof(value));
+        }
+
+        BlockFormat from_fourcc(const std::uint32_t code) {
+            switch (code) {
+            case fourcc("DXT1"):
+                return BlockFormat::BC1;
+            case fourcc("DXT5"):
+                return BlockFormat::BC3;
+            case fourcc("ATI1"):
+            case fourcc("BC4U"):
+                return BlockFormat::BC4;
+            case fourcc("BC4S"):
+                return BlockFormat::BC4_SNORM;
+            case fourcc("ATI2"):
+            case fourcc("BC5U"):
+                return BlockFormat::BC5;
+            case fourcc("BC5S"):
+                return BlockFormat::BC5_SNORM;
+            default:
+                throw std::runtime_error(std::format("Unsupported DDS FourCC 0x{:08x}", code));
+            }
+        }
+
+        BlockFormat from_dxgi(const std::uint32_t dxgi_format) {
+            switch (dxgi_format) {
+            case 71: // DXGI_FORMAT_BC1_UNORM
+                return BlockFormat::BC1;
+            case 72:
+                return BlockFormat::BC1_SRGB;
+            case 77: // DXGI_FORMAT_BC3_UNORM
+                return BlockFormat::BC3;
+            case 78:
+                return BlockFormat::BC3_SRGB;
+            case 80: // DXGI_FORMAT_BC4_UNORM
+                return BlockFormat::BC4;
+            case 81:
+                return BlockFormat::BC4_SNORM;
+            case 83: // DXGI_FORMAT_BC5_UNORM
+                return BlockFormat::BC5;
+            case 84:
+                return BlockFormat::BC5_SNORM;
+            case 98: // DXGI_FORMAT_BC7_UNORM
+                return BlockFormat::BC7;
+            case 99:
+                return BlockFormat::BC7_SRGB;
+            default:
+                throw std::runtime_error(std::format("Unsupported DXGI format {}", dxgi_format));
+            }
+        }
+
+        std::uint32_t to_dxgi(const BlockFormat format) {
+            switch (format) {
+            case BlockFormat::BC1:
+                return 71;
+            case BlockFormat::BC1_SRGB:
+                return 72;
+            case BlockFormat::BC3:
+                return 77;
+            case BlockFormat::BC3_SRGB:
+                return 78;
+            case BlockFormat::BC4:
+                return 80;
+            case BlockFormat::BC4_SNORM:
+                return 81;
+            case BlockFormat::BC5:
+                return 83;
+            case BlockFormat::BC5_SNORM:
+                return 84;
+            case BlockFormat::BC7:
+                return 98;
+            case BlockFormat::BC7_SRGB:
+                return 99;
+            default:
+                throw std::invalid_argument("Invalid block format");
+            }
+        }
+    } // namespace
+
+    bool is_dds(const std::span<const std::uint8_t> file) {
+        return file.size() >= 4 && read_u32(file, 0) == fourcc("DDS ");
+    }
+
+    CompressedImageView parse_dds_view(const std::span<const std::uint8_t> file) {
+        if (file.size() < header_offset + header_size || read_u32(file, 0) != fourcc("DDS ") || read_u32(file, header_offset) != header_size) {
+            throw std::runtime_error("Not a DDS file");
+        }
+
+        const auto header = file.subspan(header_offset, header_size);
+        const auto flags  = read_u32(header, flags_field);
+        const bool volume = (flags & flag_depth) != 0 && read_u32(header, depth_field) > 1;
+        if (volume || (read_u32(header, caps2_field) & (caps2_cube_map | caps2_volume)) != 0) {
+            throw std::runtime_error("Only 2D DDS textures are supported");
+        }
+        if ((read_u32(header, pixel_flags_field) & pixel_fourcc) == 0) {
+            throw std::runtime_error("Uncompressed DDS textures are not supported");
+        }
+
+        CompressedImageView image {};
+        image.width  = read_u32(header, width_field);
+        image.height = read_u32(header, height_field);
+        image.levels = (flags & flag_mip_count) != 0 ? std::max(read_u32(header, mip_count_field), 1u) : 1;
+        if (image.width == 0 || image.height == 0 || image.levels > mip_level_count(image.width, image.height)) {
+            throw std::runtime_error(std::format("Bad DDS dimensions {}x{} with {} levels", image.width, image.height, image.levels));
+        }
+
+        std::size_t data_offset = dx10_header_offset;
+        if (const auto code = read_u32(header, fourcc_field); code == fourcc("DX10")) {
+            if (file.size() < dx10_header_offset + dx10_header_size) {
+                throw std::runtime_error("Truncated DDS file");
+            }
+
+            const auto dx10 = file.subspan(dx10_header_offset, dx10_header_size);
+            if (read_u32(dx10, 4) != dimension_texture_2d || (read_u32(dx10, 8) & misc_texture_cube) != 0 || read_u32(dx10, 12) > 1) {
+                throw std::runtime_error("Only 2D DDS textures are supported");
+            }
+
+            image.format = from_dxgi(read_u32(dx10, 0));
+            data_offset += dx10_header_size;
+        } else {
+            image.format = from_fourcc(code);
+        }
+
+        std::size_t size = 0;
+        for (unsigned int level = 0; level < image.levels; level++) {
+            size += compressed_size(image.format, mip_extent(image.width, level), mip_extent(image.height, level));
+        }
+        if (file.size() < data_offset + size) {
+            throw std::runtime_error("Truncated DDS file");
+        }
+
+        image.data = file.subspan(data_offset, size);
+        return image;
+    }
+
+    CompressedImage parse_dds(const std::span<const std::uint8_t> file) {
+        const CompressedImageView view = parse_dds_view(file);
+        return {view.format, view.width, view.height, view.levels, {view.data.begin(), view.data.end()}};
+    }
+
+    CompressedImage load_dds(const std::filesystem::path &path) {
+        std::ifstream f(path, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!f) {
+            throw std::runtime_error(std::format("Failed to open {}", path.string()));
+        }
+
+        const std::streampos      end = f.tellg();
+        std::vector<std::uint8_t> file(static_cast<std::size_t>(end));
+        f.seekg(0, std::ios::beg);
+        f.read(reinterpret_cast<char *>(file.data()), end);
+
+        return parse_dds(file);
+    }
+
+    std::vector<std::uint8_t> write_dds(const CompressedImage &image) {
+        const std::size_t         size = image.level_offset(image.levels);
+        std::vector<std::uint8_t> file(dx10_header_offset + dx10_header_size + size);
+
+        write_u32(file, 0, fourcc("DDS "));
+
+        const auto header = std::span(file).subspan(header_offset, header_size);
+        write_u32(header, 0, header_size);
+        write_u32(header, flags_field, flags_required | flag_linear | (image.levels > 1 ? flag_mip_count : 0));
+        write_u32(header, height_field, image.height);
+        write_u32(header, width_field, image.width);
+        write_u32(header, linear_size_field, static_cast<std::uint32_t>(image.level_size(0)));
+        write_u32(header, mip_count_field, image.levels);
+        write_u32(header, pixel_size_field, 32);
+        write_u32(header, pixel_flags_field, pixel_fourcc);
+        write_u32(header, fourcc_field, fourcc("DX10"));
+        write_u32(header, caps_field, caps_texture | (image.levels > 1 ? caps_mipmap : 0));
+
+        const auto dx10 = std::span(file).subspan(dx10_header_offset, dx10_header_size);
+        write_u32(dx10, 0, to_dxgi(image.format));
+        write_u32(dx10, 4, dimension_texture_2d);
+        write_u32(dx10, 12, 1); // array size
+
+        std::memcpy(file.data() + dx10_header_offset + dx10_header_size, image.data.data(), size);
+        return file;
+    }
+} // namespace game::image
@@ -0,0 +1,68 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace game::image {
+    // Block-compressed formats, all of which encode 4x4 texel blocks.
+    enum class BlockFormat {
+        BC1,
+        BC1_SRGB,
+        BC3,
+        BC3_SRGB,
+        BC4,
+        BC4_SNORM,
+        BC5,
+        BC5_SNORM,
+        BC7,
+        BC7_SRGB,
+    };
+
+    // 8 bytes for BC1 and BC4, 16 for the rest
+    std::size_t block_size(BlockFormat format);
+
+    // bytes one level of the given size takes, partial blocks at the edges counting as whole ones
+    std::size_t compressed_size(BlockFormat format, unsigned int width, unsigned int height);
+
+    // A compressed image whose levels live elsewhere, like in a mapped file.
+    struct CompressedImageView {
+        BlockFormat  format;
+        unsigned int width, height;
+        unsigned int levels;
+        // levels packed one after another, largest first
+        std::span<const std::uint8_t> data;
+    };
+
+    struct CompressedImage {
+        BlockFormat  format;
+        unsigned int width, height;
+        unsigned int levels;
+        // levels packed one after another, largest first
+        std::vector<std::uint8_t> data;
+
+        [[nodiscard]] std::size_t level_offset(unsigned int level) const;
+        [[nodiscard]] std::size_t level_size(unsigned int level) const;
+
+        [[nodiscard]] CompressedImageView view() const noexcept { return {format, width, height, levels, data}; }
+    };
+
+    // Reads a 2D DDS file in one of the block formats, either with a legacy FourCC (DXT1, DXT5, ATI1/BC4U/BC4S, ATI2/BC5U/BC5S) or with a DX10
+    // header. Rows are taken as stored, so files have to hold them bottom row first like every other image the game loads (blocks can't be
+    // flipped in general). Cube maps, volumes and arrays are rejected.
+    CompressedImage parse_dds(std::span<const std::uint8_t> file);
+    // checks the magic only
+    [[nodiscard]] bool is_dds(std::span<const std::uint8_t> file);
+    // the same without copying the levels out of `file`
+    CompressedImageView parse_dds_view(std::span<const std::uint8_t> file);
+    CompressedImage load_dds(const std::filesystem::path &path);
+
+    // Serializes `image` with a DX10 header, which parse_dds reads back.
+    std::vector<std::uint8_t> write_dds(const CompressedImage &image);
+} // namespace game::image
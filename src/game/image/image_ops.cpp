@@ -0,0 +1,109 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/image/image_ops.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GAME_IMAGE_SSE2 1
+#endif
+
+namespace game::image {
+    unsigned int mip_level_count(const unsigned int width, const unsigned int height) {
+        return std::bit_width(std::max({width, height, 1u}));
+    }
+
+    std::size_t mip_chain_size_rgba8(const unsigned int width, const unsigned int height, const unsigned int levels) {
+        std::size_t size = 0;
+        for (unsigned int level = 0; level < levels; level++) {
+            size += static_cast<std::size_t>(mip_extent(width, level)) * mip_extent(height, level) * 4;
+        }
+        return size;
+    }
+
+    namespace {
+        void downsample_texel(const std::uint8_t *row0,
+                              const std::uint8_t *row1,
+                              const unsigned int  x0,
+                              const unsigned int  x1,
+                              std::uint8_t       *out) {
+            for (unsigned int c = 0; c < 4; c++) {
+                const unsigned int sum = row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c];
+                out[c]                 = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+
+#ifdef GAME_IMAGE_SSE2
+        // two output texels from four input texels of each row
+        unsigned int downsample_row_sse2(const std::uint8_t *row0, const std::uint8_t *row1, const unsigned int out_width, std::uint8_t *out) {
+            const __m128i zero     = _mm_setzero_si128();
+            const __m128i rounding = _mm_set1_epi16(2);
+
+            unsigned int x = 0;
+            for (; x + 2 <= out_width; x += 2) {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 8));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 8));
+
+                // vertical sums, 16 bits per channel: texels 0 and 1 in `low`, 2 and 3 in `high`
+                const __m128i low  = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                const __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+                // horizontal sums of neighbouring texels: fold the upper texel of each pair onto the lower one
+                const __m128i sum_low  = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+                const __m128i sum_high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+
+                const __m128i sums   = _mm_unpacklo_epi64(sum_low, sum_high);
+                const __m128i result = _mm_srli_epi16(_mm_add_epi16(sums, rounding), 2);
+
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(out + x * 4), _mm_packus_epi16(result, zero));
+            }
+            return x;
+        }
+#endif
+    } // namespace
+
+    void downsample_box_rgba8(const std::span<const std::uint8_t> source,
+                              const unsigned int                  width,
+                              const unsigned int                  height,
+                              const std::span<std::uint8_t>       destination) {
+        const unsigned int out_width  = mip_extent(width, 1);
+        const unsigned int out_height = mip_extent(height, 1);
+        if (source.size() < static_cast<std::size_t>(width) * height * 4 || destination.size() < static_cast<std::size_t>(out_width) * out_height * 4) {
+            throw std::invalid_argument("Image buffer too small for its size");
+        }
+
+        for (unsigned int y = 0; y < out_height; y++) {
+            const std::uint8_t *row0 = source.data() + static_cast<std::size_t>(std::min(y * 2, height - 1)) * width * 4;
+            const std::uint8_t *row1 = source.data() + static_cast<std::size_t>(std::min(y * 2 + 1, height - 1)) * width * 4;
+            std::uint8_t       *out  = destination.data() + static_cast<std::size_t>(y) * out_width * 4;
+
+            unsigned int x = 0;
+#ifdef GAME_IMAGE_SSE2
+            // the vector path reads texel pairs, a single column is left to the scalar loop
+            if (width >= 2) {
+                x = downsample_row_sse2(row0, row1, out_width, out);
+            }
+#endif
+            for (; x < out_width; x++) {
+                downsample_texel(row0, row1, std::min(x * 2, width - 1), std::min(x * 2 + 1, width - 1), out + x * 4);
+            }
+        }
+    }
+
+    void generate_mip_chain_rgba8(const std::span<std::uint8_t> chain, const unsigned int width, const unsigned int height, const unsigned int levels) {
+        std::size_t offset = 0;
+        for (unsigned int level = 1; level < levels; level++) {
+            const unsigned int w    = mip_extent(width, level - 1);
+            const unsigned int h    = mip_extent(height, level - 1);
+            const std::size_t  size = static_cast<std::size_t>(w) * h * 4;
+
+            downsample_box_rgba8(chain.subspan(offset, size), w, h, chain.subspan(offset + size));
+            offset += size;
+        }
+    }
+} // namespace game::image
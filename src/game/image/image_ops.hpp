@@ -0,0 +1,30 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace game::image {
+    // levels in a full mip chain down to 1x1
+    unsigned int mip_level_count(unsigned int width, unsigned int height);
+
+    // size of one dimension at a mip level, never less than one
+    constexpr unsigned int mip_extent(const unsigned int extent, const unsigned int level) {
+        return extent >> level == 0 ? 1 : extent >> level;
+    }
+
+    // bytes needed for `levels` levels of a tightly packed RGBA8 chain
+    std::size_t mip_chain_size_rgba8(unsigned int width, unsigned int height, unsigned int levels);
+
+    // Halves an RGBA8 image with a 2x2 box filter (rounding to nearest). Mip sizes round down, so the last row or column of an odd dimension is
+    // dropped; a dimension of one is kept and filtered only along the other. `destination` must hold mip_extent(width, 1) * mip_extent(height, 1)
+    // texels.
+    void downsample_box_rgba8(std::span<const std::uint8_t> source, unsigned int width, unsigned int height, std::span<std::uint8_t> destination);
+
+    // Fills levels 1 and up of a chain whose level 0 is already in place, levels tightly packed one after another.
+    void generate_mip_chain_rgba8(std::span<std::uint8_t> chain, unsigned int width, unsigned int height, unsigned int levels);
+} // namespace game::image
@@ -0,0 +1,539 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/image/pixel_convert.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define GAME_IMAGE_X86 1
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC compiles intrinsics of any instruction set without being told
+#define GAME_IMAGE_TARGET(isa)
+#else
+#define GAME_IMAGE_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+// Each kernel converts as much as its vector width allows and returns how far it got, the scalar loop does the rest. The vector paths produce
+// exactly what the scalar one does.
+
+namespace game::image {
+    namespace {
+        SimdLevel detect() {
+#ifdef GAME_IMAGE_X86
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            const int max_leaf = info[0];
+            __cpuid(info, 1);
+            const bool sse4 = (info[2] & (1 << 19)) != 0;
+            // AVX registers also need saving by the OS
+            const bool ymm  = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+            bool       avx2 = false;
+            if (max_leaf >= 7 && ymm) {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            const bool sse4 = __builtin_cpu_supports("sse4.1");
+            const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+            if (avx2) {
+                return SimdLevel::AVX2;
+            }
+            if (sse4) {
+                return SimdLevel::SSE4;
+            }
+#endif
+            return SimdLevel::Scalar;
+        }
+
+        const SimdLevel        detected = detect();
+        std::atomic<SimdLevel> active   = detected;
+
+        void check_channels(const unsigned int channels) {
+            if (channels < 1 || channels > 4) {
+                throw std::invalid_argument("Images have one to four channels");
+            }
+        }
+
+        void check_size(const std::size_t needed, const std::size_t available) {
+            if (available < needed) {
+                throw std::invalid_argument("Image buffer too small for its size");
+            }
+        }
+
+        // grey with alpha and RGBA images have alpha as their last channel
+        bool is_alpha(const std::size_t index, const unsigned int channels) {
+            return (channels == 2 || channels == 4) && index % channels == channels - 1;
+        }
+
+        // NaN goes to zero, like it does in the vector paths
+        float saturate(const float value) {
+            return value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+        }
+
+        const float *srgb_decode_table() {
+            static const std::vector<float> table = [] {
+                std::vector<float> decoded(256);
+                for (std::size_t i = 0; i < decoded.size(); i++) {
+                    const float c = static_cast<float>(i) / 255.0f;
+                    decoded[i]    = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return decoded;
+            }();
+            return table.data();
+        }
+
+        // Indexed by the linear value quantized to 16 bits, which is fine enough for every 8-bit result to come out as if computed exactly,
+        // give or take a rounding tie. Padded by three bytes for the 32-bit gathers of the AVX2 path.
+        constexpr std::size_t encode_steps = 65535;
+
+        const std::uint8_t *srgb_encode_table() {
+            static const std::vector<std::uint8_t> table = [] {
+                std::vector<std::uint8_t> encoded(encode_steps + 1 + 3);
+                for (std::size_t i = 0; i <= encode_steps; i++) {
+                    const float c = static_cast<float>(i) / static_cast<float>(encode_steps);
+                    const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                    encoded[i]    = static_cast<std::uint8_t>(saturate(s) * 255.0f + 0.5f);
+                }
+                return encoded;
+            }();
+            return table.data();
+        }
+
+        std::uint8_t premultiply(const std::uint8_t color, const std::uint8_t alpha) {
+            // exact rounding division by 255
+            const unsigned int t = color * alpha + 128u;
+            return static_cast<std::uint8_t>((t + (t >> 8)) >> 8);
+        }
+
+#ifdef GAME_IMAGE_X86
+        // ---- SSE4 (with SSSE3 shuffles) ----
+
+        GAME_IMAGE_TARGET("sse4.1")
+        std::size_t expand_sse4(const std::uint8_t *source, const unsigned int channels, std::uint8_t *destination, const std::size_t texels) {
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            std::size_t   x     = 0;
+            switch (channels) {
+            case 1: {
+                const __m128i masks[4] = {_mm_setr_epi8(0, 0, 0, -128, 1, 1, 1, -128, 2, 2, 2, -128, 3, 3, 3, -128),
+                                          _mm_setr_epi8(4, 4, 4, -128, 5, 5, 5, -128, 6, 6, 6, -128, 7, 7, 7, -128),
+                                          _mm_setr_epi8(8, 8, 8, -128, 9, 9, 9, -128, 10, 10, 10, -128, 11, 11, 11, -128),
+                                          _mm_setr_epi8(12, 12, 12, -128, 13, 13, 13, -128, 14, 14, 14, -128, 15, 15, 15, -128)};
+                for (; x + 16 <= texels; x += 16) {
+                    const __m128i grey = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x));
+                    for (int i = 0; i < 4; i++) {
+                        const __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(grey, masks[i]), alpha);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + (x + i * 4) * 4), rgba);
+                    }
+                }
+                break;
+            }
+            case 2: {
+                const __m128i low  = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+                const __m128i high = _mm_setr_epi8(8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+                for (; x + 8 <= texels; x += 8) {
+                    const __m128i pairs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 2));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x * 4), _mm_shuffle_epi8(pairs, low));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + x * 4 + 16), _mm_shuffle_epi8(pairs, high));
+                }
+                break;
+            }
+            case 3: {
+                // 16 texels from exactly 48 bytes: realign each group of four texels to the start of a register, then spread it out
+                const __m128i mask = _mm_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+                for (; x + 16 <= texels; x += 16) {
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 3));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 3 + 16));
+                    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 3 + 32));
+
+                    const __m128i groups[4] = {a, _mm_alignr_epi8(b, a, 12), _mm_alignr_epi8(c, b, 8), _mm_srli_si128(c, 4)};
+                    for (int i = 0; i < 4; i++) {
+                        const __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(groups[i], mask), alpha);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + (x + i * 4) * 4), rgba);
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            return x;
+        }
+
+        GAME_IMAGE_TARGET("sse4.1")
+        std::size_t swap_sse4(std::uint8_t *a, std::uint8_t *b, const std::size_t size) {
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+                const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(a + i), vb);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(b + i), va);
+            }
+            return i;
+        }
+
+        // c * a / 255 per 16-bit lane, the same rounding as premultiply()
+        GAME_IMAGE_TARGET("sse4.1") __m128i scale_sse4(const __m128i color, const __m128i alpha) {
+            const __m128i t = _mm_add_epi16(_mm_mullo_epi16(color, alpha), _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+
+        GAME_IMAGE_TARGET("sse4.1")
+        std::size_t premultiply_sse4(std::uint8_t *pixels, const std::size_t texels) {
+            // alpha spread over the colour lanes, the alpha lane itself is scaled by 255 so it stays as it is
+            const __m128i low    = _mm_setr_epi8(3, -128, 3, -128, 3, -128, -128, -128, 7, -128, 7, -128, 7, -128, -128, -128);
+            const __m128i high   = _mm_setr_epi8(11, -128, 11, -128, 11, -128, -128, -128, 15, -128, 15, -128, 15, -128, -128, -128);
+            const __m128i opaque = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+            const __m128i zero   = _mm_setzero_si128();
+
+            std::size_t x = 0;
+            for (; x + 4 <= texels; x += 4) {
+                const __m128i texel = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + x * 4));
+                const __m128i a     = scale_sse4(_mm_unpacklo_epi8(texel, zero), _mm_or_si128(_mm_shuffle_epi8(texel, low), opaque));
+                const __m128i b     = scale_sse4(_mm_unpackhi_epi8(texel, zero), _mm_or_si128(_mm_shuffle_epi8(texel, high), opaque));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + x * 4), _mm_packus_epi16(a, b));
+            }
+            return x;
+        }
+
+        // unorm only, the sRGB tables want gathers
+        GAME_IMAGE_TARGET("sse4.1")
+        std::size_t u8_to_float_sse4(const std::uint8_t *source, float *destination, const std::size_t count) {
+            const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+            std::size_t  i     = 0;
+            for (; i + 4 <= count; i += 4) {
+                std::int32_t packed;
+                std::memcpy(&packed, source + i, sizeof(packed));
+                const __m128i values = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+                _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(values), scale));
+            }
+            return i;
+        }
+
+        GAME_IMAGE_TARGET("sse4.1")
+        std::size_t float_to_u8_sse4(const float *source, std::uint8_t *destination, const std::size_t count) {
+            const __m128 zero  = _mm_setzero_ps();
+            const __m128 one   = _mm_set1_ps(1.0f);
+            const __m128 scale = _mm_set1_ps(255.0f);
+            const __m128 half  = _mm_set1_ps(0.5f);
+            std::size_t  i     = 0;
+            for (; i + 4 <= count; i += 4) {
+                // max first, which returns its second operand for NaN
+                const __m128  value  = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i), zero), one);
+                const __m128i ints   = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+                const __m128i words  = _mm_packus_epi32(ints, ints);
+                const auto    packed = static_cast<std::int32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(words, words)));
+                std::memcpy(destination + i, &packed, sizeof(packed));
+            }
+            return i;
+        }
+
+        // ---- AVX2 ----
+
+        GAME_IMAGE_TARGET("avx2")
+        std::size_t expand_avx2(const std::uint8_t *source, const unsigned int channels, std::uint8_t *destination, const std::size_t texels) {
+            // shuffles stay within 128-bit lanes, so each lane is given the source bytes of the texels it produces
+            const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+            std::size_t   x     = 0;
+            switch (channels) {
+            case 1: {
+                const __m256i masks[2] = {_mm256_setr_epi8(0, 0, 0, -128, 1, 1, 1, -128, 2, 2, 2, -128, 3, 3, 3, -128,
+                                                           4, 4, 4, -128, 5, 5, 5, -128, 6, 6, 6, -128, 7, 7, 7, -128),
+                                          _mm256_setr_epi8(8, 8, 8, -128, 9, 9, 9, -128, 10, 10, 10, -128, 11, 11, 11, -128,
+                                                           12, 12, 12, -128, 13, 13, 13, -128, 14, 14, 14, -128, 15, 15, 15, -128)};
+                for (; x + 16 <= texels; x += 16) {
+                    const __m256i grey = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x)));
+                    for (int i = 0; i < 2; i++) {
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + (x + i * 8) * 4),
+                                            _mm256_or_si256(_mm256_shuffle_epi8(grey, masks[i]), alpha));
+                    }
+                }
+                break;
+            }
+            case 2: {
+                const __m256i mask = _mm256_setr_epi8(
+                    0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7, 8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+                for (; x + 8 <= texels; x += 8) {
+                    const __m256i pairs = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 2)));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x * 4), _mm256_shuffle_epi8(pairs, mask));
+                }
+                break;
+            }
+            case 3: {
+                const __m256i mask = _mm256_setr_epi8(
+                    0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128, 0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+                // the upper lane loads 16 bytes from the 12th on, so 28 bytes have to be there
+                for (; x + 10 <= texels; x += 8) {
+                    const __m128i low  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 3));
+                    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x * 3 + 12));
+                    const __m256i rgb  = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + x * 4), _mm256_or_si256(_mm256_shuffle_epi8(rgb, mask), alpha));
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            return x;
+        }
+
+        GAME_IMAGE_TARGET("avx2")
+        std::size_t swap_avx2(std::uint8_t *a, std::uint8_t *b, const std::size_t size) {
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+                const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), vb);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(b + i), va);
+            }
+            return i;
+        }
+
+        GAME_IMAGE_TARGET("avx2") __m256i scale_avx2(const __m256i color, const __m256i alpha) {
+            const __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(color, alpha), _mm256_set1_epi16(128));
+            return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+        }
+
+        GAME_IMAGE_TARGET("avx2")
+        std::size_t premultiply_avx2(std::uint8_t *pixels, const std::size_t texels) {
+            // unpacking and shuffling both work per lane, so the masks are the SSE4 ones twice
+            const __m256i low  = _mm256_setr_epi8(3, -128, 3, -128, 3, -128, -128, -128, 7, -128, 7, -128, 7, -128, -128, -128,
+                                                  3, -128, 3, -128, 3, -128, -128, -128, 7, -128, 7, -128, 7, -128, -128, -128);
+            const __m256i high = _mm256_setr_epi8(11, -128, 11, -128, 11, -128, -128, -128, 15, -128, 15, -128, 15, -128, -128, -128,
+                                                  11, -128, 11, -128, 11, -128, -128, -128, 15, -128, 15, -128, 15, -128, -128, -128);
+            const __m256i opaque = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+            const __m256i zero   = _mm256_setzero_si256();
+
+            std::size_t x = 0;
+            for (; x + 8 <= texels; x += 8) {
+                const __m256i texel = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + x * 4));
+                const __m256i a = scale_avx2(_mm256_unpacklo_epi8(texel, zero), _mm256_or_si256(_mm256_shuffle_epi8(texel, low), opaque));
+                const __m256i b = scale_avx2(_mm256_unpackhi_epi8(texel, zero), _mm256_or_si256(_mm256_shuffle_epi8(texel, high), opaque));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(pixels + x * 4), _mm256_packus_epi16(a, b));
+            }
+            return x;
+        }
+
+        // lanes holding alpha when starting at a texel boundary; eight values always cover whole texels of 1, 2 or 4 channels, and 3 has no alpha
+        GAME_IMAGE_TARGET("avx2") __m256i alpha_lanes_avx2(const unsigned int channels) {
+            std::int32_t lanes[8];
+            for (std::size_t i = 0; i < 8; i++) {
+                lanes[i] = is_alpha(i, channels) ? -1 : 0;
+            }
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+        }
+
+        GAME_IMAGE_TARGET("avx2")
+        std::size_t u8_to_float_avx2(
+            const std::uint8_t *source, float *destination, const std::size_t count, const unsigned int channels, const bool srgb) {
+            const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+            const __m256 alpha = _mm256_castsi256_ps(alpha_lanes_avx2(channels));
+            const float *table = srgb_decode_table();
+
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i values = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + i)));
+                __m256        result = _mm256_mul_ps(_mm256_cvtepi32_ps(values), scale);
+                if (srgb) {
+                    result = _mm256_blendv_ps(_mm256_i32gather_ps(table, values, 4), result, alpha);
+                }
+                _mm256_storeu_ps(destination + i, result);
+            }
+            return i;
+        }
+
+        GAME_IMAGE_TARGET("avx2")
+        std::size_t float_to_u8_avx2(
+            const float *source, std::uint8_t *destination, const std::size_t count, const unsigned int channels, const bool srgb) {
+            const __m256  zero  = _mm256_setzero_ps();
+            const __m256  one   = _mm256_set1_ps(1.0f);
+            const __m256  scale = _mm256_set1_ps(255.0f);
+            const __m256  steps = _mm256_set1_ps(static_cast<float>(encode_steps));
+            const __m256  half  = _mm256_set1_ps(0.5f);
+            const __m256i alpha = alpha_lanes_avx2(channels);
+            const auto   *table = reinterpret_cast<const int *>(srgb_encode_table());
+            const __m256i byte  = _mm256_set1_epi32(0xFF);
+
+            std::size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256 value = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(source + i), zero), one);
+                __m256i      ints  = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, scale), half));
+                if (srgb) {
+                    // byte-wise lookups through 32-bit gathers at byte granularity, keeping the lowest byte
+                    const __m256i index   = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, steps), half));
+                    const __m256i encoded = _mm256_and_si256(_mm256_i32gather_epi32(table, index, 1), byte);
+                    ints                  = _mm256_blendv_epi8(encoded, ints, alpha);
+                }
+
+                const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(ints), _mm256_extracti128_si256(ints, 1));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(destination + i), _mm_packus_epi16(words, words));
+            }
+            return i;
+        }
+#endif
+    } // namespace
+
+    SimdLevel detect_simd_level() {
+        return detected;
+    }
+
+    SimdLevel get_simd_level() {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    void set_simd_level(const SimdLevel level) {
+        active.store(std::min(level, detected), std::memory_order_relaxed);
+    }
+
+    void expand_to_rgba8(const std::span<const std::uint8_t> source, const unsigned int channels, const std::span<std::uint8_t> destination) {
+        check_channels(channels);
+        const std::size_t texels = source.size() / channels;
+        check_size(texels * 4, destination.size());
+
+        if (channels == 4) {
+            std::memcpy(destination.data(), source.data(), texels * 4);
+            return;
+        }
+
+        std::size_t x = 0;
+#ifdef GAME_IMAGE_X86
+        switch (get_simd_level()) {
+        case SimdLevel::AVX2:
+            x = expand_avx2(source.data(), channels, destination.data(), texels);
+            break;
+        case SimdLevel::SSE4:
+            x = expand_sse4(source.data(), channels, destination.data(), texels);
+            break;
+        default:
+            break;
+        }
+#endif
+        for (; x < texels; x++) {
+            const std::uint8_t *in  = source.data() + x * channels;
+            std::uint8_t       *out = destination.data() + x * 4;
+            if (channels <= 2) {
+                out[0] = out[1] = out[2] = in[0];
+                out[3]                   = channels == 2 ? in[1] : 255;
+            } else {
+                out[0] = in[0];
+                out[1] = in[1];
+                out[2] = in[2];
+                out[3] = 255;
+            }
+        }
+    }
+
+    void flip_rows(const std::span<std::uint8_t> pixels, const std::size_t row_size) {
+        if (row_size == 0 || pixels.size() % row_size != 0) {
+            throw std::invalid_argument("Image buffer doesn't hold whole rows");
+        }
+
+        const std::size_t rows = pixels.size() / row_size;
+        for (std::size_t y = 0; y < rows / 2; y++) {
+            std::uint8_t *top    = pixels.data() + y * row_size;
+            std::uint8_t *bottom = pixels.data() + (rows - 1 - y) * row_size;
+
+            std::size_t i = 0;
+#ifdef GAME_IMAGE_X86
+            switch (get_simd_level()) {
+            case SimdLevel::AVX2:
+                i = swap_avx2(top, bottom, row_size);
+                break;
+            case SimdLevel::SSE4:
+                i = swap_sse4(top, bottom, row_size);
+                break;
+            default:
+                break;
+            }
+#endif
+            std::swap_ranges(top + i, top + row_size, bottom + i);
+        }
+    }
+
+    void premultiply_alpha_rgba8(const std::span<std::uint8_t> pixels) {
+        const std::size_t texels = pixels.size() / 4;
+
+        std::size_t x = 0;
+#ifdef GAME_IMAGE_X86
+        switch (get_simd_level()) {
+        case SimdLevel::AVX2:
+            x = premultiply_avx2(pixels.data(), texels);
+            break;
+        case SimdLevel::SSE4:
+            x = premultiply_sse4(pixels.data(), texels);
+            break;
+        default:
+            break;
+        }
+#endif
+        for (; x < texels; x++) {
+            std::uint8_t *texel = pixels.data() + x * 4;
+            for (int c = 0; c < 3; c++) {
+                texel[c] = premultiply(texel[c], texel[3]);
+            }
+        }
+    }
+
+    void u8_to_float(const std::span<const std::uint8_t> source, const std::span<float> destination, const unsigned int channels, const bool srgb) {
+        check_channels(channels);
+        check_size(source.size(), destination.size());
+
+        std::size_t i = 0;
+#ifdef GAME_IMAGE_X86
+        switch (get_simd_level()) {
+        case SimdLevel::AVX2:
+            i = u8_to_float_avx2(source.data(), destination.data(), source.size(), channels, srgb);
+            break;
+        case SimdLevel::SSE4:
+            i = srgb ? 0 : u8_to_float_sse4(source.data(), destination.data(), source.size());
+            break;
+        default:
+            break;
+        }
+#endif
+        const float *table = srgb_decode_table();
+        for (; i < source.size(); i++) {
+            destination[i] = srgb && !is_alpha(i, channels) ? table[source[i]] : static_cast<float>(source[i]) * (1.0f / 255.0f);
+        }
+    }
+
+    void float_to_u8(const std::span<const float> source, const std::span<std::uint8_t> destination, const unsigned int channels, const bool srgb) {
+        check_channels(channels);
+        check_size(source.size(), destination.size());
+
+        std::size_t i = 0;
+#ifdef GAME_IMAGE_X86
+        switch (get_simd_level()) {
+        case SimdLevel::AVX2:
+            i = float_to_u8_avx2(source.data(), destination.data(), source.size(), channels, srgb);
+            break;
+        case SimdLevel::SSE4:
+            i = srgb ? 0 : float_to_u8_sse4(source.data(), destination.data(), source.size());
+            break;
+        default:
+            break;
+        }
+#endif
+        const std::uint8_t *table = srgb_encode_table();
+        for (; i < source.size(); i++) {
+            const float value = saturate(source[i]);
+            if (srgb && !is_alpha(i, channels)) {
+                destination[i] = table[static_cast<std::size_t>(value * static_cast<float>(encode_steps) + 0.5f)];
+            } else {
+                destination[i] = static_cast<std::uint8_t>(value * 255.0f + 0.5f);
+            }
+        }
+    }
+} // namespace game::image
@@ -0,0 +1,39 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace game::image {
+    // Instruction sets the conversion kernels below have paths for. The best one the CPU supports is picked at startup.
+    enum class SimdLevel {
+        Scalar,
+        SSE4,
+        AVX2,
+    };
+
+    [[nodiscard]] SimdLevel detect_simd_level();
+
+    // The level the kernels run at: the detected one unless lowered, e.g. to compare the paths. Raising it past the detected level has no effect.
+    [[nodiscard]] SimdLevel get_simd_level();
+    void                    set_simd_level(SimdLevel level);
+
+    // Expands 8-bit texels with 1 (grey), 2 (grey, alpha), 3 (RGB) or 4 channels to RGBA8, with opaque alpha where there was none. Converts
+    // source.size() / channels texels.
+    void expand_to_rgba8(std::span<const std::uint8_t> source, unsigned int channels, std::span<std::uint8_t> destination);
+
+    // Reverses the order of the rows in place, each of them `row_size` bytes.
+    void flip_rows(std::span<std::uint8_t> pixels, std::size_t row_size);
+
+    // Multiplies the colour of RGBA8 texels by their alpha, rounding to nearest.
+    void premultiply_alpha_rgba8(std::span<std::uint8_t> pixels);
+
+    // 8-bit unsigned normalized to float and back, with `channels` interleaved channels. With `srgb` the colour channels are decoded from and
+    // encoded to sRGB, while alpha (the last of 2 or 4 channels) stays linear. Floats are clamped to [0, 1].
+    void u8_to_float(std::span<const std::uint8_t> source, std::span<float> destination, unsigned int channels, bool srgb);
+    void float_to_u8(std::span<const float> source, std::span<std::uint8_t> destination, unsigned int channels, bool srgb);
+} // namespace game::image
@@ -0,0 +1,242 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/image/qoi.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace game::image {
+    namespace {
+        constexpr std::uint8_t magic[4]      = {'q', 'o', 'i', 'f'};
+        constexpr std::size_t  header_size   = 14;
+        constexpr std::uint8_t end_marker[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+        constexpr std::uint8_t op_index = 0x00;
+        constexpr std::uint8_t op_diff  = 0x40;
+        constexpr std::uint8_t op_luma  = 0x80;
+        constexpr std::uint8_t op_run   = 0xc0;
+        constexpr std::uint8_t op_rgb   = 0xfe;
+        constexpr std::uint8_t op_rgba  = 0xff;
+        constexpr std::uint8_t op_mask  = 0xc0;
+
+        // the reference implementation's limit
+        constexpr std::uint64_t max_texels = 400'000'000;
+
+        // texels are handled as one 32-bit value, which stores as R, G, B, A in memory
+        static_assert(std::endian::native == std::endian::little);
+        using Texel = std::uint32_t;
+
+        constexpr Texel opaque_black = 0xff000000u;
+
+        std::uint32_t read_u32_be(const std::uint8_t *bytes) {
+            return static_cast<std::uint32_t>(bytes[0]) << 24 | static_cast<std::uint32_t>(bytes[1]) << 16 |
+                   static_cast<std::uint32_t>(bytes[2]) << 8 | bytes[3];
+        }
+
+        void write_u32_be(std::vector<std::uint8_t> &out, const std::uint32_t value) {
+            out.insert(out.end(),
+                       {static_cast<std::uint8_t>(value >> 24),
+                        static_cast<std::uint8_t>(value >> 16),
+                        static_cast<std::uint8_t>(value >> 8),
+                        static_cast<std::uint8_t>(value)});
+        }
+
+        // (r * 3 + g * 5 + b * 7 + a * 11) % 64 with a single multiply: spreading the channels so that each product lands in the top byte
+        // with its factor, and nothing below carries into it
+        unsigned int hash(const Texel texel) {
+            std::uint64_t spread = texel;
+            spread               = (spread | spread << 32) & 0xff00ff0000ff00ffull;
+            return static_cast<unsigned int>((spread * 0x030007000005000bull) >> 56) & 63;
+        }
+
+        // adds signed deltas to the colour channels, each wrapping around within its byte
+        Texel add_rgb(const Texel texel, const int dr, const int dg, const int db) {
+            const auto r = static_cast<std::uint8_t>((texel & 0xff) + dr);
+            const auto g = static_cast<std::uint8_t>((texel >> 8 & 0xff) + dg);
+            const auto b = static_cast<std::uint8_t>((texel >> 16 & 0xff) + db);
+            return (texel & 0xff000000u) | static_cast<Texel>(b) << 16 | static_cast<Texel>(g) << 8 | r;
+        }
+
+        template <unsigned int Channels> void store(std::uint8_t *out, const Texel texel) {
+            std::memcpy(out, &texel, Channels);
+        }
+
+        template <unsigned int Channels>
+        void decode_texels(const QoiHeader &header, const std::uint8_t *p, const std::uint8_t *end, std::uint8_t *destination, const bool flip) {
+            const std::size_t row_size = static_cast<std::size_t>(header.width) * Channels;
+
+            Texel        cache[64] = {};
+            Texel        texel     = opaque_black;
+            unsigned int run       = 0;
+            for (unsigned int y = 0; y < header.height; y++) {
+                std::uint8_t *out = destination + (flip ? header.height - 1 - y : y) * row_size;
+                for (unsigned int x = 0; x < header.width;) {
+                    // runs carry on across rows
+                    if (run > 0) {
+                        const unsigned int count = std::min(run, header.width - x);
+                        for (unsigned int i = 0; i < count; i++) {
+                            store<Channels>(out + (x + i) * Channels, texel);
+                        }
+                        run -= count;
+                        x += count;
+                        continue;
+                    }
+
+                    // chunks take at most five bytes, which the end marker leaves room for without checking each of them
+                    if (p >= end) {
+                        throw std::runtime_error("QOI image is truncated");
+                    }
+
+                    const std::uint8_t op = *p++;
+                    if (op == op_rgb) {
+                        texel = (texel & 0xff000000u) | static_cast<Texel>(p[2]) << 16 | static_cast<Texel>(p[1]) << 8 | p[0];
+                        p += 3;
+                    } else if (op == op_rgba) {
+                        std::memcpy(&texel, p, sizeof(texel));
+                        p += 4;
+                    } else {
+                        switch (op & op_mask) {
+                        case op_index:
+                            texel = cache[op];
+                            break;
+                        case op_diff:
+                            texel = add_rgb(texel, (op >> 4 & 3) - 2, (op >> 2 & 3) - 2, (op & 3) - 2);
+                            break;
+                        case op_luma: {
+                            const std::uint8_t second = *p++;
+                            const int          dg     = (op & 0x3f) - 32;
+                            texel                     = add_rgb(texel, dg - 8 + (second >> 4), dg, dg - 8 + (second & 0x0f));
+                            break;
+                        }
+                        default:
+                            run = (op & 0x3f) + 1;
+                            continue;
+                        }
+                    }
+
+                    cache[hash(texel)] = texel;
+                    store<Channels>(out + x * Channels, texel);
+                    x++;
+                }
+            }
+        }
+    } // namespace
+
+    bool is_qoi(const std::span<const std::uint8_t> file) {
+        return file.size() >= sizeof(magic) && std::memcmp(file.data(), magic, sizeof(magic)) == 0;
+    }
+
+    QoiHeader parse_qoi_header(const std::span<const std::uint8_t> file) {
+        if (!is_qoi(file) || file.size() < header_size + sizeof(end_marker)) {
+            throw std::runtime_error("Not a QOI image");
+        }
+
+        const QoiHeader header {read_u32_be(file.data() + 4), read_u32_be(file.data() + 8), file[12], file[13] == 1};
+        if (header.width == 0 || header.height == 0 || (header.channels != 3 && header.channels != 4) ||
+            static_cast<std::uint64_t>(header.width) * header.height > max_texels) {
+            throw std::runtime_error("Invalid QOI header");
+        }
+        return header;
+    }
+
+    void decode_qoi(const std::span<const std::uint8_t> file,
+                    const unsigned int                  channels,
+                    const std::span<std::uint8_t>       destination,
+                    const bool                          flip) {
+        const QoiHeader header = parse_qoi_header(file);
+        if (channels != 3 && channels != 4) {
+            throw std::invalid_argument("QOI images decode to RGB or RGBA");
+        }
+        if (destination.size() < static_cast<std::size_t>(header.width) * header.height * channels) {
+            throw std::invalid_argument("Image buffer too small for its size");
+        }
+
+        const std::uint8_t *chunks = file.data() + header_size;
+        const std::uint8_t *end    = file.data() + file.size() - sizeof(end_marker);
+        if (channels == 4) {
+            decode_texels<4>(header, chunks, end, destination.data(), flip);
+        } else {
+            decode_texels<3>(header, chunks, end, destination.data(), flip);
+        }
+    }
+
+    std::vector<std::uint8_t> encode_qoi(const std::span<const std::uint8_t> pixels,
+                                         const unsigned int                  width,
+                                         const unsigned int                  height,
+                                         const unsigned int                  channels,
+                                         const bool                          linear) {
+        if (channels != 3 && channels != 4) {
+            throw std::invalid_argument("QOI images hold RGB or RGBA");
+        }
+        const std::size_t texels = static_cast<std::size_t>(width) * height;
+        if (width == 0 || height == 0 || texels > max_texels || pixels.size() < texels * channels) {
+            throw std::invalid_argument("Invalid image size for QOI");
+        }
+
+        std::vector<std::uint8_t> out(std::begin(magic), std::end(magic));
+        // worst case: every texel as a full RGBA chunk
+        out.reserve(header_size + texels * (channels + 1) + sizeof(end_marker));
+        write_u32_be(out, width);
+        write_u32_be(out, height);
+        out.push_back(static_cast<std::uint8_t>(channels));
+        out.push_back(linear ? 1 : 0);
+
+        Texel        cache[64] = {};
+        Texel        previous  = opaque_black;
+        unsigned int run       = 0;
+        for (std::size_t i = 0; i < texels; i++) {
+            Texel texel = opaque_black;
+            std::memcpy(&texel, pixels.data() + i * channels, channels);
+
+            if (texel == previous) {
+                run++;
+                if (run == 62 || i + 1 == texels) {
+                    out.push_back(op_run | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                out.push_back(op_run | (run - 1));
+                run = 0;
+            }
+
+            const unsigned int slot = hash(texel);
+            if (cache[slot] == texel) {
+                out.push_back(op_index | slot);
+            } else {
+                cache[slot] = texel;
+
+                if ((texel ^ previous) >> 24 == 0) {
+                    const auto dr   = static_cast<std::int8_t>((texel & 0xff) - (previous & 0xff));
+                    const auto dg   = static_cast<std::int8_t>((texel >> 8 & 0xff) - (previous >> 8 & 0xff));
+                    const auto db   = static_cast<std::int8_t>((texel >> 16 & 0xff) - (previous >> 16 & 0xff));
+                    const int  dg_r = dr - dg;
+                    const int  dg_b = db - dg;
+
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        out.push_back(op_diff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                    } else if (dg >= -32 && dg <= 31 && dg_r >= -8 && dg_r <= 7 && dg_b >= -8 && dg_b <= 7) {
+                        out.push_back(op_luma | (dg + 32));
+                        out.push_back((dg_r + 8) << 4 | (dg_b + 8));
+                    } else {
+                        out.push_back(op_rgb);
+                        out.insert(out.end(), pixels.data() + i * channels, pixels.data() + i * channels + 3);
+                    }
+                } else {
+                    out.push_back(op_rgba);
+                    out.insert(out.end(), pixels.data() + i * channels, pixels.data() + i * channels + 4);
+                }
+            }
+            previous = texel;
+        }
+
+        out.insert(out.end(), std::begin(end_marker), std::end(end_marker));
+        return out;
+    }
+} // namespace game::image
@@ -0,0 +1,32 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace game::image {
+    // QOI ("Quite OK Image") is a lossless RGB/RGBA format that compresses about as well as PNG for sprites and UI art but decodes several
+    // times faster, as every texel is a single byte-oriented op against the previous texel or a 64-entry cache of recent ones.
+    struct QoiHeader {
+        unsigned int width, height;
+        unsigned int channels; // 3 or 4, as encoded
+        bool         linear;   // informational: all channels linear rather than sRGB colour with linear alpha
+    };
+
+    [[nodiscard]] bool is_qoi(std::span<const std::uint8_t> file);
+    // throws when `file` isn't a QOI image or is too short to hold one
+    QoiHeader parse_qoi_header(std::span<const std::uint8_t> file);
+
+    // Decodes to `channels` (3 or 4) bytes per texel regardless of what's stored, alpha being 255 for RGB images. QOI stores the top row first;
+    // with `flip` rows are written bottom row first like every other image the game loads. `destination` must hold width * height * channels
+    // bytes.
+    void decode_qoi(std::span<const std::uint8_t> file, unsigned int channels, std::span<std::uint8_t> destination, bool flip);
+
+    // Encodes tightly packed 3 or 4 channel texels, top row first.
+    std::vector<std::uint8_t>
+    encode_qoi(std::span<const std::uint8_t> pixels, unsigned int width, unsigned int height, unsigned int channels, bool linear = false);
+} // namespace game::image
@@ -0,0 +1,103 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/image/skyline_packer.hpp"
+
+#include <algorithm>
+
+namespace game::image {
+    SkylinePacker::SkylinePacker(const unsigned int width, const unsigned int height) : m_Width(width), m_Height(height) {
+        clear();
+    }
+
+    void SkylinePacker::clear() {
+        m_Skyline  = {{0, 0, m_Width}};
+        m_UsedArea = 0;
+    }
+
+    std::optional<unsigned int> SkylinePacker::fit(const std::size_t index, const unsigned int width, const unsigned int height) const {
+        if (m_Skyline[index].x + width > m_Width) {
+            return std::nullopt;
+        }
+
+        unsigned int y         = 0;
+        unsigned int remaining = width;
+        for (std::size_t i = index; remaining > 0; i++) {
+            y = std::max(y, m_Skyline[i].y);
+            if (y + height > m_Height) {
+                return std::nullopt;
+            }
+            remaining -= std::min(remaining, m_Skyline[i].width);
+        }
+        return y;
+    }
+
+    std::optional<PackedRect> SkylinePacker::insert(const unsigned int width, const unsigned int height) {
+        if (width == 0 || height == 0) {
+            return std::nullopt;
+        }
+
+        std::size_t  best_index = m_Skyline.size();
+        unsigned int best_top   = ~0u;
+        unsigned int best_width = ~0u;
+        unsigned int best_y     = 0;
+        for (std::size_t i = 0; i < m_Skyline.size(); i++) {
+            const auto y = fit(i, width, height);
+            if (!y) {
+                continue;
+            }
+
+            // lowest top edge first, then the narrowest spot to leave wide gaps for later rectangles
+            if (*y + height < best_top || (*y + height == best_top && m_Skyline[i].width < best_width)) {
+                best_index = i;
+                best_top   = *y + height;
+                best_width = m_Skyline[i].width;
+                best_y     = *y;
+            }
+        }
+
+        if (best_index == m_Skyline.size()) {
+            return std::nullopt;
+        }
+
+        const PackedRect rect {m_Skyline[best_index].x, best_y, width, height};
+        m_Skyline.insert(m_Skyline.begin() + static_cast<std::ptrdiff_t>(best_index), {rect.x, rect.y + height, width});
+
+        // shrink or drop the nodes the new one now covers
+        for (std::size_t i = best_index + 1; i < m_Skyline.size();) {
+            auto      &node = m_Skyline[i];
+            const auto end  = rect.x + width;
+            if (node.x >= end) {
+                break;
+            }
+
+            const unsigned int overlap = end - node.x;
+            if (overlap >= node.width) {
+                m_Skyline.erase(m_Skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+
+            node.x += overlap;
+            node.width -= overlap;
+            break;
+        }
+
+        // merge neighbours at the same height
+        for (std::size_t i = 0; i + 1 < m_Skyline.size();) {
+            if (m_Skyline[i].y == m_Skyline[i + 1].y) {
+                m_Skyline[i].width += m_Skyline[i + 1].width;
+                m_Skyline.erase(m_Skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            } else {
+                i++;
+            }
+        }
+
+        m_UsedArea += static_cast<unsigned long>(width) * height;
+        return rect;
+    }
+
+    float SkylinePacker::get_occupancy() const noexcept {
+        return static_cast<float>(m_UsedArea) / (static_cast<float>(m_Width) * static_cast<float>(m_Height));
+    }
+} // namespace game::image
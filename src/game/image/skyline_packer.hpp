@@ -0,0 +1,47 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+namespace game::image {
+    struct PackedRect {
+        unsigned int x, y;
+        unsigned int width, height;
+    };
+
+    // Packs rectangles into a fixed-size area one at a time, tracking the upper outline ("skyline") of what's been placed and putting each new
+    // rectangle where it ends up lowest (bottom-left rule). Cheap enough for incremental insertion at runtime, at some cost in density
+    // compared to MaxRects.
+    class SkylinePacker {
+      public:
+        SkylinePacker(unsigned int width, unsigned int height);
+
+        // nullopt when the rectangle fits nowhere
+        std::optional<PackedRect> insert(unsigned int width, unsigned int height);
+
+        void clear();
+
+        [[nodiscard]] unsigned int get_width() const noexcept { return m_Width; }
+        [[nodiscard]] unsigned int get_height() const noexcept { return m_Height; }
+
+        // fraction of the area covered by inserted rectangles
+        [[nodiscard]] float get_occupancy() const noexcept;
+
+      private:
+        struct Node {
+            unsigned int x, y, width;
+        };
+
+        // the y a rectangle starting at node `index` would rest at, nullopt if it doesn't fit there
+        [[nodiscard]] std::optional<unsigned int> fit(std::size_t index, unsigned int width, unsigned int height) const;
+
+        unsigned int      m_Width;
+        unsigned int      m_Height;
+        std::vector<Node> m_Skyline;
+        unsigned long     m_UsedArea = 0;
+    };
+} // namespace game::image
@@ -0,0 +1,122 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/barrier_tracker.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace game::render {
+    namespace {
+        // every access kind an incoherent write must eventually be made visible to
+        constexpr GLbitfield all_access_bits =
+            GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT |
+            GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT |
+            GL_BUFFER_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT | GL_TRANSFORM_FEEDBACK_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT |
+            GL_SHADER_STORAGE_BARRIER_BIT | GL_QUERY_BUFFER_BARRIER_BIT;
+
+        BarrierTracker::Access write_hazard_access(const BarrierTracker::Write write) {
+            switch (write) {
+            case BarrierTracker::Write::ImageStore:
+                return BarrierTracker::Access::ShaderImage;
+            case BarrierTracker::Write::ShaderStorage:
+                return BarrierTracker::Access::ShaderStorage;
+            case BarrierTracker::Write::AtomicCounter:
+                return BarrierTracker::Access::AtomicCounter;
+            case BarrierTracker::Write::Framebuffer:
+                return BarrierTracker::Access::Framebuffer;
+            default:
+                throw std::invalid_argument("Invalid write kind");
+            }
+        }
+
+        BarrierTracker::Write binding_write(const BarrierTracker::Binding::Point point) {
+            switch (point) {
+            case BarrierTracker::Binding::Point::Image:
+                return BarrierTracker::Write::ImageStore;
+            case BarrierTracker::Binding::Point::ShaderStorage:
+                return BarrierTracker::Write::ShaderStorage;
+            case BarrierTracker::Binding::Point::AtomicCounter:
+                return BarrierTracker::Write::AtomicCounter;
+            default:
+                throw std::invalid_argument("Invalid binding point");
+            }
+        }
+    } // namespace
+
+    BarrierTracker &BarrierTracker::get() {
+        thread_local BarrierTracker tracker;
+        return tracker;
+    }
+
+    void BarrierTracker::bind(const Binding binding, const Resource resource, const bool writable) {
+        unbind(binding);
+        if (writable) {
+            m_BoundWrites.emplace_back(binding, resource);
+        }
+    }
+
+    void BarrierTracker::unbind(const Binding binding) {
+        std::erase_if(m_BoundWrites, [&](const auto &bound) { return bound.first == binding; });
+    }
+
+    void BarrierTracker::commit_writes() {
+        for (const auto &[binding, resource] : m_BoundWrites) {
+            write(resource, binding_write(binding.point));
+        }
+    }
+
+    void BarrierTracker::write(const Resource resource, const Write write) {
+        read(resource, write_hazard_access(write));
+
+        if (write != Write::Framebuffer) {
+            m_Pending[resource] = all_access_bits;
+            m_Outstanding |= all_access_bits;
+        }
+    }
+
+    void BarrierTracker::read(const Resource resource, const Access access) {
+        m_Statistics.accesses_checked++;
+
+        const auto bits = static_cast<GLbitfield>(access);
+        if ((m_Outstanding & bits) == 0) {
+            return;
+        }
+
+        const auto it = m_Pending.find(resource);
+        if (it == m_Pending.end() || (it->second & bits) == 0) {
+            return;
+        }
+
+        barrier(bits);
+    }
+
+    void BarrierTracker::flush() {
+        if (m_Outstanding != 0) {
+            barrier(m_Outstanding);
+        }
+    }
+
+    void BarrierTracker::forget(const Resource resource) {
+        std::erase_if(m_BoundWrites, [&](const auto &bound) { return bound.second == resource; });
+        m_Pending.erase(resource);
+    }
+
+    void BarrierTracker::barrier(const GLbitfield bits) {
+        glMemoryBarrier(bits);
+        m_Statistics.barriers_issued++;
+
+        // a barrier is global, so it resolves this kind of hazard for every resource at once
+        m_Outstanding = 0;
+        for (auto it = m_Pending.begin(); it != m_Pending.end();) {
+            it->second &= ~bits;
+            if (it->second == 0) {
+                it = m_Pending.erase(it);
+            } else {
+                m_Outstanding |= it->second;
+                ++it;
+            }
+        }
+    }
+} // namespace game::render
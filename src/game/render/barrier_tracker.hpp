@@ -0,0 +1,117 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glad/gl.h>
+#include <unordered_map>
+#include <vector>
+
+namespace game::render {
+
+    // Tracks incoherent shader writes (image stores, SSBO writes, atomic counters) per resource and emits the smallest glMemoryBarrier that
+    // makes them visible, right before the first access that actually depends on them. Writes through the framebuffer are coherent with later
+    // commands and therefore never need a barrier of their own, but they still have to wait on any outstanding incoherent write.
+    class BarrierTracker {
+      public:
+        // How a resource is about to be read (or written, for write-after-write hazards). Each value is the barrier bit which makes prior
+        // incoherent writes visible to that kind of access.
+        enum class Access : GLbitfield {
+            VertexAttribArray = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+            ElementArray      = GL_ELEMENT_ARRAY_BARRIER_BIT,
+            Uniform           = GL_UNIFORM_BARRIER_BIT,
+            TextureFetch      = GL_TEXTURE_FETCH_BARRIER_BIT,
+            ShaderImage       = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+            Command           = GL_COMMAND_BARRIER_BIT,
+            PixelBuffer       = GL_PIXEL_BUFFER_BARRIER_BIT,
+            TextureUpdate     = GL_TEXTURE_UPDATE_BARRIER_BIT,
+            BufferUpdate      = GL_BUFFER_UPDATE_BARRIER_BIT,
+            Framebuffer       = GL_FRAMEBUFFER_BARRIER_BIT,
+            TransformFeedback = GL_TRANSFORM_FEEDBACK_BARRIER_BIT,
+            AtomicCounter     = GL_ATOMIC_COUNTER_BARRIER_BIT,
+            ShaderStorage     = GL_SHADER_STORAGE_BARRIER_BIT,
+            QueryBuffer       = GL_QUERY_BUFFER_BARRIER_BIT,
+        };
+
+        enum class Write {
+            ImageStore,
+            ShaderStorage,
+            AtomicCounter,
+            Framebuffer,
+        };
+
+        struct Resource {
+            enum class Kind : std::uint8_t {
+                Texture,
+                Buffer,
+            };
+
+            Kind         kind;
+            unsigned int handle;
+
+            bool operator==(const Resource &other) const = default;
+        };
+
+        // An indexed binding point a shader can write through.
+        struct Binding {
+            enum class Point : std::uint8_t {
+                Image,
+                ShaderStorage,
+                AtomicCounter,
+            };
+
+            Point        point;
+            unsigned int index;
+
+            bool operator==(const Binding &other) const = default;
+        };
+
+        struct Statistics {
+            std::size_t accesses_checked;
+            std::size_t barriers_issued;
+        };
+
+        // The tracker mirrors state of the GL context current on the calling thread.
+        static BarrierTracker &get();
+
+        // Records that `resource` is bound to `binding`, replacing whatever was bound there before. If `writable`, the next dispatch or draw is
+        // assumed to write to it.
+        void bind(Binding binding, Resource resource, bool writable);
+        void unbind(Binding binding);
+
+        // Turns every resource bound for writing into an outstanding write. Call after each dispatch or draw.
+        void commit_writes();
+
+        void write(Resource resource, Write write);
+        void read(Resource resource, Access access);
+
+        // Makes every outstanding write visible to every kind of access.
+        void flush();
+
+        // Must be called when a tracked object is deleted, so a recycled handle doesn't inherit the hazards of the old object.
+        void forget(Resource resource);
+
+        [[nodiscard]] const Statistics &get_statistics() const noexcept { return m_Statistics; }
+
+        void reset_statistics() noexcept { m_Statistics = {}; }
+
+      private:
+        struct ResourceHash {
+            std::size_t operator()(const Resource &resource) const noexcept {
+                return std::hash<std::uint64_t>()(static_cast<std::uint64_t>(resource.kind) << 32 | resource.handle);
+            }
+        };
+
+        void barrier(GLbitfield bits);
+
+        // barrier bits still required before each kind of access may observe the last incoherent write to a resource
+        std::unordered_map<Resource, GLbitfield, ResourceHash> m_Pending;
+        std::vector<std::pair<Binding, Resource>>              m_BoundWrites;
+        GLbitfield                                             m_Outstanding = 0;
+        Statistics                                             m_Statistics {};
+    };
+
+} // namespace game::render
@@ -0,0 +1,59 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/binding_set.hpp"
+#include "game/render/state_cache.hpp"
+
+#include <stdexcept>
+
+namespace game::render {
+    TextureBindingSet::TextureBindingSet(const unsigned int first_unit) : m_FirstUnit(first_unit) {}
+
+    void TextureBindingSet::set_texture(const unsigned int unit, const Texture *texture) {
+        if (unit < m_FirstUnit) {
+            throw std::out_of_range("Texture unit is below the first unit of the binding set");
+        }
+
+        const unsigned int index = unit - m_FirstUnit;
+        if (index >= m_Textures.size()) {
+            m_Textures.resize(index + 1, 0);
+            m_Samplers.resize(index + 1, 0);
+        }
+
+        m_Textures[index] = texture == nullptr ? 0 : texture->get_handle();
+        m_Samplers[index] = texture == nullptr ? 0 : texture->get_sampler()->get_handle();
+    }
+
+    void TextureBindingSet::set_sampler(const unsigned int unit, const Sampler *sampler) {
+        if (unit < m_FirstUnit) {
+            throw std::out_of_range("Texture unit is below the first unit of the binding set");
+        }
+
+        const unsigned int index = unit - m_FirstUnit;
+        if (index >= m_Samplers.size()) {
+            m_Textures.resize(index + 1, 0);
+            m_Samplers.resize(index + 1, 0);
+        }
+
+        m_Samplers[index] = sampler == nullptr ? 0 : sampler->get_handle();
+    }
+
+    void TextureBindingSet::clear() {
+        m_Textures.clear();
+        m_Samplers.clear();
+    }
+
+    void TextureBindingSet::apply() const {
+        auto &tracker = BarrierTracker::get();
+        for (const auto texture : m_Textures) {
+            if (texture != 0) {
+                tracker.read({BarrierTracker::Resource::Kind::Texture, texture}, BarrierTracker::Access::TextureFetch);
+            }
+        }
+
+        auto &cache = StateCache::get();
+        cache.bind_textures(m_FirstUnit, m_Textures);
+        cache.bind_samplers(m_FirstUnit, m_Samplers);
+    }
+} // namespace game::render
@@ -0,0 +1,40 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/render/render.hpp"
+
+#include <vector>
+
+namespace game::render {
+
+    // Collects the textures (and optionally samplers) a draw or dispatch reads from consecutive texture units, and binds all of them with one
+    // glBindTextures/glBindSamplers call each. Units which already hold the right object are left out of the call.
+    class TextureBindingSet {
+      public:
+        explicit TextureBindingSet(unsigned int first_unit = 0);
+
+        // `unit` is absolute, units between first_unit and the highest unit set which were never assigned are bound to 0. Also assigns the
+        // texture's own sampler to the unit.
+        void set_texture(unsigned int unit, const Texture *texture);
+        // overrides the sampler of a unit, set after set_texture
+        void set_sampler(unsigned int unit, const Sampler *sampler);
+
+        void clear();
+
+        void apply() const;
+
+        [[nodiscard]] unsigned int get_first_unit() const noexcept { return m_FirstUnit; }
+
+        [[nodiscard]] unsigned int get_unit_count() const noexcept { return static_cast<unsigned int>(m_Textures.size()); }
+
+      private:
+        unsigned int m_FirstUnit;
+
+        std::vector<unsigned int> m_Textures;
+        std::vector<unsigned int> m_Samplers;
+    };
+
+} // namespace game::render
@@ -0,0 +1,112 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/pipeline.hpp"
+#include "game/hash.hpp"
+
+#include <stdexcept>
+
+namespace game::render {
+    std::size_t PipelineDescription::hash() const noexcept {
+        std::size_t seed = 0;
+        hash_combine(seed, program ? program->get_handle() : 0u);
+        hash_combine(seed, vertex_layout.hash());
+
+        hash_combine(seed, blend.enabled);
+        hash_combine(seed, static_cast<GLenum>(blend.src_color));
+        hash_combine(seed, static_cast<GLenum>(blend.dst_color));
+        hash_combine(seed, static_cast<GLenum>(blend.src_alpha));
+        hash_combine(seed, static_cast<GLenum>(blend.dst_alpha));
+        hash_combine(seed, static_cast<GLenum>(blend.color_op));
+        hash_combine(seed, static_cast<GLenum>(blend.alpha_op));
+
+        hash_combine(seed, depth.test);
+        hash_combine(seed, depth.write);
+        hash_combine(seed, static_cast<GLenum>(depth.compare));
+
+        hash_combine(seed, stencil.test);
+        hash_combine(seed, static_cast<GLenum>(stencil.compare));
+        hash_combine(seed, stencil.reference);
+        hash_combine(seed, stencil.read_mask);
+        hash_combine(seed, stencil.write_mask);
+        hash_combine(seed, static_cast<GLenum>(stencil.fail));
+        hash_combine(seed, static_cast<GLenum>(stencil.depth_fail));
+        hash_combine(seed, static_cast<GLenum>(stencil.pass));
+
+        hash_combine(seed, static_cast<GLenum>(rasterizer.cull_mode));
+        hash_combine(seed, static_cast<GLenum>(rasterizer.front_face));
+        hash_combine(seed, static_cast<GLenum>(rasterizer.polygon_mode));
+        hash_combine(seed, rasterizer.scissor_test);
+
+        hash_combine(seed, color_mask.r);
+        hash_combine(seed, color_mask.g);
+        hash_combine(seed, color_mask.b);
+        hash_combine(seed, color_mask.a);
+        return seed;
+    }
+
+    Pipeline::Pipeline(const PipelineDescription &description, const std::uint32_t id)
+        : m_Description(description), m_Id(id), m_VertexLayoutHash(description.vertex_layout.hash()) {
+        if (!m_Description.program) {
+            throw std::invalid_argument("A pipeline needs a shader program");
+        }
+    }
+
+    void Pipeline::bind() const {
+        auto &cache = StateCache::get();
+        if (cache.is_pipeline_bound(m_Id)) {
+            return;
+        }
+
+        // each of these only touches the GL state which actually differs
+        cache.use_program(m_Description.program->get_handle());
+        cache.set_blend_state(m_Description.blend);
+        cache.set_depth_state(m_Description.depth);
+        cache.set_stencil_state(m_Description.stencil);
+        cache.set_rasterizer_state(m_Description.rasterizer);
+        cache.set_color_mask(m_Description.color_mask);
+
+        cache.set_bound_pipeline(m_Id);
+    }
+
+    const PipelineDescription &Pipeline::get_description() const noexcept {
+        return m_Description;
+    }
+
+    const ShaderProgram &Pipeline::get_program() const noexcept {
+        return *m_Description.program;
+    }
+
+    std::uint32_t Pipeline::get_id() const noexcept {
+        return m_Id;
+    }
+
+    bool Pipeline::is_compatible(const VertexArray &vertex_array) const noexcept {
+        return vertex_array.get_layout_hash() == m_VertexLayoutHash;
+    }
+
+    std::shared_ptr<const Pipeline> Pipeline::create(const PipelineDescription &description) {
+        return PipelineCache::get().get_pipeline(description);
+    }
+
+    PipelineCache &PipelineCache::get() {
+        thread_local PipelineCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const Pipeline> PipelineCache::get_pipeline(const PipelineDescription &description) {
+        const auto it = m_Pipelines.find(description);
+        if (it != m_Pipelines.end()) {
+            return it->second;
+        }
+
+        auto pipeline = std::make_shared<const Pipeline>(description, m_NextId++);
+        m_Pipelines.emplace(description, pipeline);
+        return pipeline;
+    }
+
+    void PipelineCache::clear() {
+        m_Pipelines.clear();
+    }
+} // namespace game::render
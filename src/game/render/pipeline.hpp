@@ -0,0 +1,79 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/render/render.hpp"
+#include "game/render/state_cache.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace game::render {
+    // Everything about how draws are processed apart from the resources they use: the program, the vertex format it consumes and the
+    // fixed-function state around it.
+    struct PipelineDescription {
+        std::shared_ptr<const ShaderProgram> program;
+        VertexLayout                         vertex_layout;
+
+        BlendState      blend      = {};
+        DepthState      depth      = {};
+        StencilState    stencil    = {};
+        RasterizerState rasterizer = {};
+        ColorMask       color_mask = {};
+
+        bool operator==(const PipelineDescription &other) const = default;
+
+        [[nodiscard]] std::size_t hash() const noexcept;
+    };
+
+    // An immutable, deduplicated bundle of pipeline state, created up front through PipelineCache. Binding a pipeline only changes the state which
+    // differs from what's currently set, and nothing at all when the same pipeline is bound twice in a row.
+    class Pipeline {
+      public:
+        Pipeline(const PipelineDescription &description, std::uint32_t id);
+
+        Pipeline(const Pipeline &)            = delete;
+        Pipeline &operator=(const Pipeline &) = delete;
+
+        void bind() const;
+
+        [[nodiscard]] const PipelineDescription &get_description() const noexcept;
+        [[nodiscard]] const ShaderProgram       &get_program() const noexcept;
+
+        // small and dense (pipelines are numbered in creation order), so it fits in a sort key
+        [[nodiscard]] std::uint32_t get_id() const noexcept;
+
+        // whether a vertex array provides the attributes this pipeline expects
+        [[nodiscard]] bool is_compatible(const VertexArray &vertex_array) const noexcept;
+
+        static std::shared_ptr<const Pipeline> create(const PipelineDescription &description);
+
+      private:
+        PipelineDescription m_Description;
+        std::uint32_t       m_Id;
+        std::size_t         m_VertexLayoutHash;
+    };
+
+    // Deduplicates pipelines by description. Cached pipelines live as long as the cache (i.e. the thread owning the context).
+    class PipelineCache {
+      public:
+        static PipelineCache &get();
+
+        std::shared_ptr<const Pipeline> get_pipeline(const PipelineDescription &description);
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_Pipelines.size(); }
+
+        void clear();
+
+      private:
+        struct DescriptionHash {
+            std::size_t operator()(const PipelineDescription &description) const noexcept { return description.hash(); }
+        };
+
+        std::unordered_map<PipelineDescription, std::shared_ptr<const Pipeline>, DescriptionHash> m_Pipelines;
+        std::uint32_t                                                                           m_NextId = 0;
+    };
+} // namespace game::render
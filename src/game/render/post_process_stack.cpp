@@ -4,23 +4,73 @@
 
 #include "game/render/post_process_stack.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace game::render {
-    PostProcessingStage::PostProcessingStage() = default;
+    namespace {
+        constexpr float screen_vertices[] = {
+            -1.0f, -1.0f, 0.0f, 0.0f, //
+            1.0f,  -1.0f, 1.0f, 0.0f, //
+            1.0f,  1.0f,  1.0f, 1.0f, //
+
+            -1.0f, -1.0f, 0.0f, 0.0f, //
+            1.0f,  1.0f,  1.0f, 1.0f, //
+            -1.0f, 1.0f,  0.0f, 1.0f, //
+        };
+
+        bool is_color(const Framebuffer::Attachment attachment_point) {
+            const auto point = static_cast<GLenum>(attachment_point);
+            return point >= GL_COLOR_ATTACHMENT0 && point <= GL_COLOR_ATTACHMENT31;
+        }
+    } // namespace
+
+    std::vector<RenderTarget::Attachment> PostProcessingStage::default_outputs() {
+        return {{Framebuffer::Attachment::Color0, Format::RGBA8}};
+    }
+
+    PostProcessingStage::PostProcessingStage(std::vector<RenderTarget::Attachment> outputs) : m_Outputs(std::move(outputs)) {
+        // the next stage samples it, and compute stages bind it as an image, neither of which works with a renderbuffer
+        const bool has_color_texture = std::ranges::any_of(m_Outputs, [](const RenderTarget::Attachment &output) {
+            return output.attachment_point == Framebuffer::Attachment::Color0 && !output.renderbuffer;
+        });
+        if (!has_color_texture) {
+            throw std::invalid_argument("Post-processing stages output a Color0 texture");
+        }
+    }
 
     void PostProcessingStage::on_attached_to_stack(PostProcessingStack *stack) {
         m_Stack = stack;
     }
 
-    PostProcessingComputeStage::PostProcessingComputeStage(const std::shared_ptr<ShaderProgram> &compute_shader) : m_ComputeProgram(compute_shader) {}
+    RenderTarget::Description PostProcessingStage::get_output_description() const {
+        return {m_Stack->get_width(), m_Stack->get_height(), m_Outputs};
+    }
 
-    PostProcessingStack::PostProcessingStack(const unsigned int width, const unsigned int height) : m_Width(width), m_Height(height) {
+    PostProcessingComputeStage::PostProcessingComputeStage(const std::shared_ptr<ShaderProgram> &compute_shader,
+                                                           std::vector<RenderTarget::Attachment> outputs)
+        : PostProcessingStage(std::move(outputs)), m_ComputeProgram(compute_shader) {}
+
+    PostProcessingRenderStage::PostProcessingRenderStage(const std::shared_ptr<ShaderProgram> &graphics_program,
+                                                         std::vector<RenderTarget::Attachment> outputs)
+        : PostProcessingStage(std::move(outputs)), m_GraphicsProgram(graphics_program),
+          m_Pipeline(Pipeline::create({.program = graphics_program, .vertex_layout = {{{2, 2}}}})) {
+        // pass actions are indexed by draw buffer, which only lines up with the attachment point when there are no gaps
+        const auto color_outputs = std::ranges::count_if(m_Outputs, [](const RenderTarget::Attachment &output) {
+            return is_color(output.attachment_point);
+        });
+        for (const auto &output : m_Outputs) {
+            if (is_color(output.attachment_point) &&
+                static_cast<GLenum>(output.attachment_point) - GL_COLOR_ATTACHMENT0 >= static_cast<GLenum>(color_outputs)) {
+                throw std::invalid_argument("Render stage color outputs must be contiguous from Color0");
+            }
+        }
+    }
 
-        
+    PostProcessingStack::PostProcessingStack(const unsigned int width, const unsigned int height) : m_Width(width), m_Height(height) {
         m_ScreenVAO = std::make_unique<VertexArray>();
         m_ScreenVBO = std::make_unique<Buffer>(sizeof(screen_vertices), screen_vertices, Buffer::Usage::StaticDraw);
-
+        m_ScreenVAO->add_vertex_buffer(m_ScreenVBO.get(), {2, 2});
     }
 
     void PostProcessingStack::push_stage(const std::shared_ptr<PostProcessingStage> &stage) {
@@ -29,33 +79,81 @@ namespace game::render {
     }
 
     void PostProcessingStack::execute(const PostProcessingState &input_state) {
-        PostProcessingState interim_state = input_state;
-        for (const auto& stage : m_Stages) {
-            stage->execute(interim_state);
-            interim_state = { .render_target = stage->get_render_target() };
+        m_TargetPool.end_frame();
+        if (m_Stages.empty()) {
+            return;
         }
-    }
 
-    void PostProcessingComputeStage::on_attached_to_stack(PostProcessingStack *stack) {
-        PostProcessingStage::on_attached_to_stack(stack);
+        PostProcessingState interim_state = input_state;
+        // stages sample their input, which a multisampled target can't be
+        if (const RenderTarget *input = input_state.render_target; input != nullptr && input->get_samples() > 1) {
+            RenderTarget *resolved = m_TargetPool.acquire(input->get_description().resolved());
+            input->resolve(*resolved);
+            interim_state = {.render_target = resolved};
+        }
 
-        m_RenderTarget = std::make_unique<RenderTarget>(m_Stack->get_width(), m_Stack->get_height());
+        for (const auto &stage : m_Stages) {
+            stage->execute(interim_state);
+            // the input isn't the pool's for the first stage, which release ignores
+            m_TargetPool.release(interim_state.render_target);
+            interim_state = {.render_target = stage->get_render_target()};
+        }
     }
 
     RenderTarget *PostProcessingComputeStage::get_render_target() const {
-        return m_RenderTarget.get();
+        return m_RenderTarget;
     }
 
     void PostProcessingComputeStage::execute(const PostProcessingState &input_state) {
+        m_RenderTarget = m_Stack->get_target_pool().acquire(get_output_description());
+
+        const Texture *output = m_RenderTarget->get_texture(Framebuffer::Attachment::Color0);
+        input_state.render_target->get_texture(Framebuffer::Attachment::Color0)->bind_unit(0);
+        output->bind_image(0, ShaderAccess::WriteOnly, output->get_format());
+
         set_uniforms();
-        m_ComputeProgram->dispatch(m_Stack->get_width(), m_Stack->get_height(), 1);
+        m_ComputeProgram->dispatch(
+            (m_Stack->get_width() + work_group_size - 1) / work_group_size, (m_Stack->get_height() + work_group_size - 1) / work_group_size, 1);
     }
 
     void PostProcessingComputeStage::set_uniforms() const {
-        m_RenderTarget->get_texture(Framebuffer::Attachment::Color0)->bind_unit(0);
         m_ComputeProgram->uniform1i("uPostProcessingSource", 0);
     }
 
+    RenderTarget *PostProcessingRenderStage::get_render_target() const {
+        return m_RenderTarget;
+    }
+
+    void PostProcessingRenderStage::execute(const PostProcessingState &input_state) {
+        m_RenderTarget = m_Stack->get_target_pool().acquire(get_output_description());
+
+        RenderPassActions actions;
+        for (const auto &output : m_Outputs) {
+            if (is_color(output.attachment_point)) {
+                const std::size_t draw_buffer = static_cast<GLenum>(output.attachment_point) - GL_COLOR_ATTACHMENT0;
+                actions.color.resize(std::max(actions.color.size(), draw_buffer + 1));
+                actions.color[draw_buffer] = {.load = LoadOp::DontCare};
+            } else {
+                actions.depth_stencil = {.load = LoadOp::DontCare, .store = StoreOp::Discard};
+            }
+        }
+
+        m_RenderTarget->begin_pass(actions);
+        glViewport(0, 0, static_cast<GLsizei>(m_Stack->get_width()), static_cast<GLsizei>(m_Stack->get_height()));
+
+        m_Pipeline->bind();
+        input_state.render_target->get_texture(Framebuffer::Attachment::Color0)->bind_unit(0);
+        set_uniforms();
+        m_Stack->get_screen_vertex_array().bind();
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        m_RenderTarget->end_pass(actions);
+    }
+
+    void PostProcessingRenderStage::set_uniforms() const {
+        m_GraphicsProgram->uniform1i("uPostProcessingSource", 0);
+    }
+
     void PostProcessingStack::on_attached_to_stack(PostProcessingStack *stack) {
         PostProcessingStage::on_attached_to_stack(stack);
         if (m_Stack->m_Width != m_Width || m_Stack->m_Height != m_Height) {
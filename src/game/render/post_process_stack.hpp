@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "game/render/pipeline.hpp"
 #include "game/render/render.hpp"
 #include "render_target.hpp"
 #include <vector>
@@ -16,9 +17,15 @@ namespace game::render {
 
     class PostProcessingStack;
 
+    // Stages declare the attachments of their output, which is created at the stack's size: nothing they don't ask for is allocated, so a
+    // stage writing a single channel can say R8, and fullscreen passes go without a depth buffer unless they list one. Color0 has to be a
+    // texture, as that's what the next stage samples; the constructor throws otherwise.
     class PostProcessingStage {
       public:
-        PostProcessingStage();
+        // a single RGBA8 color attachment
+        [[nodiscard]] static std::vector<RenderTarget::Attachment> default_outputs();
+
+        explicit PostProcessingStage(std::vector<RenderTarget::Attachment> outputs = default_outputs());
         virtual ~PostProcessingStage() = default;
 
         virtual void on_attached_to_stack(PostProcessingStack *stack);
@@ -26,19 +33,30 @@ namespace game::render {
         virtual void          execute(const PostProcessingState &input_state) = 0;
         virtual RenderTarget *get_render_target() const                       = 0;
 
+        [[nodiscard]] const std::vector<RenderTarget::Attachment> &get_outputs() const noexcept { return m_Outputs; }
+
       protected:
-        PostProcessingStack *m_Stack;
+        // the stack's size with this stage's outputs
+        [[nodiscard]] RenderTarget::Description get_output_description() const;
+
+        PostProcessingStack                  *m_Stack;
+        std::vector<RenderTarget::Attachment> m_Outputs;
     };
 
+    // Compute stages sample the previous stage's output through `uPostProcessingSource` (texture unit 0) and write their result to image unit 0
+    // (`layout(binding = 0, <format>) writeonly uniform image2D`, the format being that of the Color0 output, rgba8 by default), using work
+    // groups of work_group_size x work_group_size invocations.
     class PostProcessingComputeStage : public PostProcessingStage {
       public:
-        explicit PostProcessingComputeStage(const std::shared_ptr<ShaderProgram> &compute_shader);
-        ~PostProcessingComputeStage() override = default;
+        static constexpr unsigned int work_group_size = 16;
 
-        void on_attached_to_stack(PostProcessingStack *stack) override;
+        explicit PostProcessingComputeStage(const std::shared_ptr<ShaderProgram> &compute_shader,
+                                            std::vector<RenderTarget::Attachment> outputs = default_outputs());
+        ~PostProcessingComputeStage() override = default;
 
         RenderTarget *get_render_target() const override;
 
+        // acquires this frame's output target from the stack's pool
         void execute(const PostProcessingState &input_state) override;
 
         virtual void set_uniforms() const;
@@ -47,27 +65,30 @@ namespace game::render {
 
       private:
         std::shared_ptr<ShaderProgram> m_ComputeProgram;
-        std::unique_ptr<RenderTarget>  m_RenderTarget;
+        RenderTarget                  *m_RenderTarget = nullptr;
     };
 
+    // Render stages draw a fullscreen quad (two float2 attributes: clip space position and texture coordinate) that samples the previous
+    // stage's output through `uPostProcessingSource` (texture unit 0). Every texel of the outputs is overwritten, so none are loaded.
     class PostProcessingRenderStage : public PostProcessingStage {
-    public:
-        explicit PostProcessingRenderStage(const std::shared_ptr<ShaderProgram> &graphics_program);
+      public:
+        explicit PostProcessingRenderStage(const std::shared_ptr<ShaderProgram> &graphics_program,
+                                           std::vector<RenderTarget::Attachment> outputs = default_outputs());
         ~PostProcessingRenderStage() override = default;
 
-        void on_attached_to_stack(PostProcessingStack *stack) override;
-
         RenderTarget *get_render_target() const override;
 
+        // acquires this frame's output target from the stack's pool
         void execute(const PostProcessingState &input_state) override;
 
         virtual void set_uniforms() const;
 
         [[nodiscard]] inline const std::shared_ptr<ShaderProgram> &get_shader() const { return m_GraphicsProgram; };
 
-    private:
-        std::shared_ptr<ShaderProgram> m_GraphicsProgram;
-        std::unique_ptr<RenderTarget>  m_RenderTarget;
+      private:
+        std::shared_ptr<ShaderProgram>  m_GraphicsProgram;
+        std::shared_ptr<const Pipeline> m_Pipeline;
+        RenderTarget                   *m_RenderTarget = nullptr;
     };
 
     class PostProcessingStack final : public PostProcessingStage {
@@ -76,6 +97,8 @@ namespace game::render {
 
         void push_stage(const std::shared_ptr<PostProcessingStage> &stage);
 
+        // Each stage's output goes back to the pool once the next stage has read it, so a stack of any length needs two targets of a kind.
+        // The last stage's output stays valid until the next execute. A multisampled input is resolved into a pooled target first.
         void execute(const PostProcessingState &input_state) override;
 
         void on_attached_to_stack(PostProcessingStack *stack) override;
@@ -86,8 +109,12 @@ namespace game::render {
 
         RenderTarget *get_render_target() const override;
 
+        [[nodiscard]] RenderTargetPool  &get_target_pool() noexcept { return m_TargetPool; }
+        [[nodiscard]] const VertexArray &get_screen_vertex_array() const noexcept { return *m_ScreenVAO; }
+
       private:
         std::vector<std::shared_ptr<PostProcessingStage>> m_Stages;
+        RenderTargetPool                                  m_TargetPool;
 
         std::unique_ptr<VertexArray> m_ScreenVAO;
         std::unique_ptr<Buffer> m_ScreenVBO;
@@ -3,7 +3,14 @@
 //
 
 #include "game/render/render.hpp"
-
+#include "game/asset_pack.hpp"
+#include "game/hash.hpp"
+#include "game/image/image_ops.hpp"
+#include "game/image/pixel_convert.hpp"
+#include "game/image/qoi.hpp"
+#include "game/render/state_cache.hpp"
+
+#include <algorithm>
 #include <format>
 #include <fstream>
 #include <stb_image.h>
@@ -20,6 +27,114 @@ namespace game::render {
         clearBackground();
     }
 
+    namespace {
+        // The default framebuffer names its attachments differently when invalidating.
+        void add_invalidation(std::vector<GLenum> &attachments, const unsigned int framebuffer, const GLenum attachment_point) {
+            if (framebuffer != 0) {
+                attachments.push_back(attachment_point);
+                return;
+            }
+
+            switch (attachment_point) {
+            case GL_DEPTH_STENCIL_ATTACHMENT:
+                attachments.push_back(GL_DEPTH);
+                attachments.push_back(GL_STENCIL);
+                break;
+            case GL_DEPTH_ATTACHMENT:
+                attachments.push_back(GL_DEPTH);
+                break;
+            case GL_STENCIL_ATTACHMENT:
+                attachments.push_back(GL_STENCIL);
+                break;
+            default:
+                attachments.push_back(GL_COLOR);
+                break;
+            }
+        }
+
+        void clear_color(const unsigned int framebuffer, const GLint draw_buffer, const ClearValue &value) {
+            // clears are masked like any other write
+            auto &cache = StateCache::get();
+            if (cache.get_color_mask() != ColorMask {}) {
+                cache.set_color_mask({});
+            }
+
+            glClearNamedFramebufferfv(framebuffer, GL_COLOR, draw_buffer, &value.color[0]);
+        }
+
+        void clear_depth_stencil(const unsigned int framebuffer, const GLenum attachment_point, const ClearValue &value) {
+            // clears are masked like any other write
+            auto &cache = StateCache::get();
+            if (attachment_point != GL_STENCIL_ATTACHMENT && !cache.get_depth_state().write) {
+                auto depth  = cache.get_depth_state();
+                depth.write = true;
+                cache.set_depth_state(depth);
+            }
+            if (attachment_point != GL_DEPTH_ATTACHMENT && cache.get_stencil_state().write_mask != 0xFF) {
+                auto stencil       = cache.get_stencil_state();
+                stencil.write_mask = 0xFF;
+                cache.set_stencil_state(stencil);
+            }
+
+            switch (attachment_point) {
+            case GL_DEPTH_STENCIL_ATTACHMENT:
+                glClearNamedFramebufferfi(framebuffer, GL_DEPTH_STENCIL, 0, value.depth, value.stencil);
+                break;
+            case GL_DEPTH_ATTACHMENT:
+                glClearNamedFramebufferfv(framebuffer, GL_DEPTH, 0, &value.depth);
+                break;
+            case GL_STENCIL_ATTACHMENT:
+                glClearNamedFramebufferiv(framebuffer, GL_STENCIL, 0, &value.stencil);
+                break;
+            default:
+                break;
+            }
+        }
+
+        void load_attachments(const unsigned int framebuffer, const RenderPassActions &actions, const GLenum depth_stencil_attachment) {
+            std::vector<GLenum> invalidate;
+
+            for (std::size_t i = 0; i < actions.color.size(); i++) {
+                const auto &color = actions.color[i];
+                if (color.load == LoadOp::Clear) {
+                    clear_color(framebuffer, static_cast<GLint>(i), color.clear);
+                } else if (color.load == LoadOp::DontCare) {
+                    add_invalidation(invalidate, framebuffer, GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i));
+                }
+            }
+
+            if (depth_stencil_attachment != GL_NONE) {
+                if (actions.depth_stencil.load == LoadOp::Clear) {
+                    clear_depth_stencil(framebuffer, depth_stencil_attachment, actions.depth_stencil.clear);
+                } else if (actions.depth_stencil.load == LoadOp::DontCare) {
+                    add_invalidation(invalidate, framebuffer, depth_stencil_attachment);
+                }
+            }
+
+            if (!invalidate.empty()) {
+                glInvalidateNamedFramebufferData(framebuffer, static_cast<GLsizei>(invalidate.size()), invalidate.data());
+            }
+        }
+
+        void store_attachments(const unsigned int framebuffer, const RenderPassActions &actions, const GLenum depth_stencil_attachment) {
+            std::vector<GLenum> invalidate;
+
+            for (std::size_t i = 0; i < actions.color.size(); i++) {
+                if (actions.color[i].store == StoreOp::Discard) {
+                    add_invalidation(invalidate, framebuffer, GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i));
+                }
+            }
+
+            if (depth_stencil_attachment != GL_NONE && actions.depth_stencil.store == StoreOp::Discard) {
+                add_invalidation(invalidate, framebuffer, depth_stencil_attachment);
+            }
+
+            if (!invalidate.empty()) {
+                glInvalidateNamedFramebufferData(framebuffer, static_cast<GLsizei>(invalidate.size()), invalidate.data());
+            }
+        }
+    } // namespace
+
     Buffer::Buffer() {
         glCreateBuffers(1, &m_Buffer);
     }
@@ -35,27 +150,158 @@ namespace game::render {
     }
 
     Buffer::~Buffer() {
+        BarrierTracker::get().forget(get_resource());
+        StateCache::get().on_buffer_deleted(m_Buffer);
         glDeleteBuffers(1, &m_Buffer);
     }
 
+    namespace {
+        BarrierTracker::Access buffer_target_access(const Buffer::Target target) {
+            switch (target) {
+            case Buffer::Target::Array:
+                return BarrierTracker::Access::VertexAttribArray;
+            case Buffer::Target::ElementArray:
+                return BarrierTracker::Access::ElementArray;
+            case Buffer::Target::Uniform:
+                return BarrierTracker::Access::Uniform;
+            case Buffer::Target::ShaderStorage:
+                return BarrierTracker::Access::ShaderStorage;
+            case Buffer::Target::AtomicCounter:
+                return BarrierTracker::Access::AtomicCounter;
+            case Buffer::Target::Texture:
+                return BarrierTracker::Access::TextureFetch;
+            case Buffer::Target::Query:
+                return BarrierTracker::Access::QueryBuffer;
+            case Buffer::Target::TransformFeedback:
+                return BarrierTracker::Access::TransformFeedback;
+            case Buffer::Target::CopyRead:
+            case Buffer::Target::CopyWrite:
+                return BarrierTracker::Access::BufferUpdate;
+            case Buffer::Target::PixelPack:
+            case Buffer::Target::PixelUnpack:
+                return BarrierTracker::Access::PixelBuffer;
+            case Buffer::Target::DispatchIndirect:
+            case Buffer::Target::DrawIndirect:
+                return BarrierTracker::Access::Command;
+            default:
+                throw std::invalid_argument("Invalid buffer target");
+            }
+        }
+    } // namespace
+
     void Buffer::bind(Target target) const {
-        glBindBuffer(static_cast<GLenum>(target), m_Buffer);
+        BarrierTracker::get().read(get_resource(), buffer_target_access(target));
+        StateCache::get().bind_buffer(static_cast<GLenum>(target), m_Buffer);
+    }
+
+    namespace {
+        // returns false for targets shaders can't write through
+        bool indexed_binding(const Buffer::IndexedTarget target, const unsigned int index, BarrierTracker::Binding &binding) {
+            switch (target) {
+            case Buffer::IndexedTarget::ShaderStorage:
+                binding = {BarrierTracker::Binding::Point::ShaderStorage, index};
+                return true;
+            case Buffer::IndexedTarget::AtomicCounter:
+                binding = {BarrierTracker::Binding::Point::AtomicCounter, index};
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        BarrierTracker::Access indexed_target_access(const Buffer::IndexedTarget target) {
+            switch (target) {
+            case Buffer::IndexedTarget::Uniform:
+                return BarrierTracker::Access::Uniform;
+            case Buffer::IndexedTarget::ShaderStorage:
+                return BarrierTracker::Access::ShaderStorage;
+            case Buffer::IndexedTarget::AtomicCounter:
+                return BarrierTracker::Access::AtomicCounter;
+            case Buffer::IndexedTarget::TransformFeedback:
+                return BarrierTracker::Access::TransformFeedback;
+            default:
+                throw std::invalid_argument("Invalid indexed buffer target");
+            }
+        }
+
+        void track_indexed_binding(const Buffer::IndexedTarget target,
+                                   const unsigned int          index,
+                                   const BarrierTracker::Resource resource,
+                                   const ShaderAccess          access) {
+            auto &tracker = BarrierTracker::get();
+            tracker.read(resource, indexed_target_access(target));
+
+            if (BarrierTracker::Binding binding {}; indexed_binding(target, index, binding)) {
+                tracker.bind(binding, resource, access != ShaderAccess::ReadOnly);
+            }
+        }
+    } // namespace
+
+    void Buffer::bind_base(const IndexedTarget target, const unsigned int index, const ShaderAccess access) const {
+        track_indexed_binding(target, index, get_resource(), access);
+        StateCache::get().bind_buffer_range(static_cast<GLenum>(target), index, m_Buffer, 0, 0);
+    }
+
+    void Buffer::bind_range(
+        const IndexedTarget target, const unsigned int index, const size_t offset, const size_t size, const ShaderAccess access) const {
+        if (size == 0) {
+            throw std::invalid_argument("Cannot bind an empty buffer range");
+        }
+
+        track_indexed_binding(target, index, get_resource(), access);
+        StateCache::get().bind_buffer_range(static_cast<GLenum>(target), index, m_Buffer, offset, size);
+    }
+
+    void Buffer::unbind_base(const IndexedTarget target, const unsigned int index) {
+        if (BarrierTracker::Binding binding {}; indexed_binding(target, index, binding)) {
+            BarrierTracker::get().unbind(binding);
+        }
+
+        StateCache::get().bind_buffer_range(static_cast<GLenum>(target), index, 0, 0, 0);
     }
 
     unsigned int Buffer::get_handle() const {
         return m_Buffer;
     }
 
+    BarrierTracker::Resource Buffer::get_resource() const noexcept {
+        return {BarrierTracker::Resource::Kind::Buffer, m_Buffer};
+    }
+
+    std::size_t VertexLayout::hash() const noexcept {
+        std::size_t seed = 0;
+        for (const auto &attributes : buffers) {
+            hash_combine(seed, attributes.size());
+            for (const auto components : attributes) {
+                hash_combine(seed, components);
+            }
+        }
+        return seed;
+    }
+
     VertexArray::VertexArray() {
         glCreateVertexArrays(1, &m_VertexArray);
     }
 
     VertexArray::~VertexArray() {
+        StateCache::get().on_vertex_array_deleted(m_VertexArray);
         glDeleteVertexArrays(1, &m_VertexArray);
     }
 
     void VertexArray::bind() const {
-        glBindVertexArray(m_VertexArray);
+        auto &tracker = BarrierTracker::get();
+        for (const auto buffer : m_VertexBuffers) {
+            tracker.read({BarrierTracker::Resource::Kind::Buffer, buffer}, BarrierTracker::Access::VertexAttribArray);
+        }
+        if (m_ElementBuffer != 0) {
+            tracker.read({BarrierTracker::Resource::Kind::Buffer, m_ElementBuffer}, BarrierTracker::Access::ElementArray);
+        }
+
+        StateCache::get().bind_vertex_array(m_VertexArray);
+    }
+
+    unsigned int VertexArray::get_handle() const noexcept {
+        return m_VertexArray;
     }
 
     void VertexArray::add_vertex_buffer(const Buffer *const buffer, const std::vector<size_t> &attributes) {
@@ -69,20 +315,35 @@ namespace game::render {
         }
 
         glVertexArrayVertexBuffer(m_VertexArray, m_NextBinding++, buffer->get_handle(), 0, stride);
+        m_VertexBuffers.push_back(buffer->get_handle());
+
+        m_Layout.buffers.push_back(attributes);
+        m_LayoutHash = m_Layout.hash();
     }
 
-    // ReSharper disable once CppMemberFunctionMayBeConst
     void VertexArray::set_element_buffer(const Buffer *const buffer) {
         glVertexArrayElementBuffer(m_VertexArray, buffer->get_handle());
+        m_ElementBuffer = buffer->get_handle();
+    }
+
+    const VertexLayout &VertexArray::get_layout() const noexcept {
+        return m_Layout;
+    }
+
+    std::size_t VertexArray::get_layout_hash() const noexcept {
+        return m_LayoutHash;
     }
 
     ShaderModule::ShaderModule(Type type, const std::string_view text) : m_Type(type) {
-        m_ShaderModule  = glCreateShader(static_cast<GLenum>(type));
-        const char *src = text.data();
+        m_ShaderModule = glCreateShader(static_cast<GLenum>(type));
+
+        const char *src    = text.data();
+        const GLint length = static_cast<GLint>(text.size());
 
         // TODO: shader preprocessing stage
 
-        glShaderSource(m_ShaderModule, 1, &src, nullptr);
+        // with its length given, as views into an asset pack aren't null-terminated
+        glShaderSource(m_ShaderModule, 1, &src, &length);
         glCompileShader(m_ShaderModule);
 
         int status;
@@ -121,6 +382,11 @@ namespace game::render {
         }
     }
 
+    ShaderProgram::~ShaderProgram() {
+        StateCache::get().on_program_deleted(m_Program);
+        glDeleteProgram(m_Program);
+    }
+
     std::shared_ptr<ShaderProgram> ShaderProgram::create(const std::vector<ShaderModule *> &modules) {
         return std::make_shared<ShaderProgram>(modules);
     }
@@ -168,6 +434,16 @@ namespace game::render {
         }
     } // namespace
 
+    std::shared_ptr<ShaderProgram> ShaderProgram::load(const AssetPack                                                  &pack,
+                                                       const std::vector<std::pair<ShaderModule::Type, std::string_view>> &paths) {
+        std::vector<std::pair<ShaderModule::Type, std::string_view>> sources;
+        sources.reserve(paths.size());
+        for (const auto &[type, path] : paths) {
+            sources.emplace_back(type, pack.get_text(path));
+        }
+        return create(sources);
+    }
+
     std::shared_ptr<ShaderProgram> ShaderProgram::load(const std::vector<std::pair<ShaderModule::Type, std::filesystem::path>> &paths) {
         std::vector<ShaderModule *> modules;
         modules.reserve(paths.size());
@@ -186,7 +462,11 @@ namespace game::render {
     }
 
     void ShaderProgram::use() const {
-        glUseProgram(m_Program);
+        StateCache::get().use_program(m_Program);
+    }
+
+    unsigned int ShaderProgram::get_handle() const noexcept {
+        return m_Program;
     }
 
     int ShaderProgram::get_uniform_location(const std::string_view name) const {
@@ -204,54 +484,281 @@ namespace game::render {
     void ShaderProgram::dispatch(const unsigned int x, const unsigned int y, const unsigned int z) const {
         use();
         glDispatchCompute(x, y, z);
-        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        // no barrier here: whatever reads the results next asks the tracker for exactly the barrier it needs
+        BarrierTracker::get().commit_writes();
+    }
+
+    bool is_compressed(const Format format) {
+        switch (format) {
+        case Format::BC1:
+        case Format::BC1_SRGB:
+        case Format::BC3:
+        case Format::BC3_SRGB:
+        case Format::BC4:
+        case Format::BC4_SNORM:
+        case Format::BC5:
+        case Format::BC5_SNORM:
+        case Format::BC7:
+        case Format::BC7_SRGB:
+            return true;
+        default:
+            return false;
+        }
     }
 
-    ImageData ImageData::load(const std::filesystem::path &path, const unsigned int desired_num_channels) {
-        ImageData data {};
-        data.pixel_type = PixelType::U8;
+    Format to_format(const image::BlockFormat format) {
+        switch (format) {
+        case image::BlockFormat::BC1:
+            return Format::BC1;
+        case image::BlockFormat::BC1_SRGB:
+            return Format::BC1_SRGB;
+        case image::BlockFormat::BC3:
+            return Format::BC3;
+        case image::BlockFormat::BC3_SRGB:
+            return Format::BC3_SRGB;
+        case image::BlockFormat::BC4:
+            return Format::BC4;
+        case image::BlockFormat::BC4_SNORM:
+            return Format::BC4_SNORM;
+        case image::BlockFormat::BC5:
+            return Format::BC5;
+        case image::BlockFormat::BC5_SNORM:
+            return Format::BC5_SNORM;
+        case image::BlockFormat::BC7:
+            return Format::BC7;
+        case image::BlockFormat::BC7_SRGB:
+            return Format::BC7_SRGB;
+        default:
+            throw std::invalid_argument("Invalid block format");
+        }
+    }
+
+    namespace {
+        std::size_t texel_size(const Format format) {
+            switch (format) {
+            case Format::R8:
+            case Format::R8I:
+            case Format::R8UI:
+            case Format::S8:
+                return 1;
+            case Format::RG8:
+            case Format::RG8I:
+            case Format::RG8UI:
+            case Format::R16:
+            case Format::R16I:
+            case Format::R16UI:
+            case Format::D16:
+            case Format::S16:
+                return 2;
+            case Format::RGB8:
+            case Format::RGB8I:
+            case Format::RGB8UI:
+                return 3;
+            case Format::RGBA8:
+            case Format::RGBA8I:
+            case Format::RGBA8UI:
+            case Format::RG16:
+            case Format::RG16I:
+            case Format::RG16UI:
+            case Format::R32F:
+            case Format::R32I:
+            case Format::R32UI:
+            case Format::D24S8:
+            case Format::D24: // padded to 32 bits by every driver
+            case Format::D32F:
+                return 4;
+            case Format::RGB16:
+            case Format::RGB16I:
+            case Format::RGB16UI:
+                return 6;
+            case Format::RGBA16:
+            case Format::RGBA16I:
+            case Format::RGBA16UI:
+            case Format::RG32F:
+            case Format::RG32I:
+            case Format::RG32UI:
+            case Format::D32FS8:
+                return 8;
+            case Format::RGB32F:
+            case Format::RGB32I:
+            case Format::RGB32UI:
+                return 12;
+            case Format::RGBA32F:
+            case Format::RGBA32I:
+            case Format::RGBA32UI:
+                return 16;
+            default:
+                throw std::invalid_argument("Invalid format");
+            }
+        }
+
+        image::BlockFormat to_block_format(const Format format) {
+            switch (format) {
+            case Format::BC1:
+                return image::BlockFormat::BC1;
+            case Format::BC1_SRGB:
+                return image::BlockFormat::BC1_SRGB;
+            case Format::BC3:
+                return image::BlockFormat::BC3;
+            case Format::BC3_SRGB:
+                return image::BlockFormat::BC3_SRGB;
+            case Format::BC4:
+                return image::BlockFormat::BC4;
+            case Format::BC4_SNORM:
+                return image::BlockFormat::BC4_SNORM;
+            case Format::BC5:
+                return image::BlockFormat::BC5;
+            case Format::BC5_SNORM:
+                return image::BlockFormat::BC5_SNORM;
+            case Format::BC7:
+                return image::BlockFormat::BC7;
+            case Format::BC7_SRGB:
+                return image::BlockFormat::BC7_SRGB;
+            default:
+                throw std::invalid_argument("Not a compressed format");
+            }
+        }
+
+        // GL thread only, like the textures themselves
+        std::size_t total_texture_memory = 0;
+    } // namespace
+
+    std::size_t image_size(const Format format, const unsigned int width, const unsigned int height) {
+        if (is_compressed(format)) {
+            return image::compressed_size(to_block_format(format), width, height);
+        }
+        return static_cast<std::size_t>(width) * height * texel_size(format);
+    }
+
+    namespace {
+        // stb only decodes: its vertical flip and channel conversion are scalar loops, done here with the SIMD kernels instead. Expanding to
+        // RGBA writes the rows in flipped order right away.
+        ImageData finish_load(PooledBlock decoded, const int w, const int h, const int nc, const unsigned int desired, const bool flip) {
+            if (decoded == nullptr) {
+                throw std::runtime_error("Failed to load texture");
+            }
+
+            const unsigned int components = desired != 0 ? desired : nc;
+            ImageData          data {std::move(decoded), static_cast<unsigned int>(w), static_cast<unsigned int>(h), components, PixelType::U8};
+            auto              *pixels   = static_cast<std::uint8_t *>(data.data.get());
+            const std::size_t  row_size = static_cast<std::size_t>(data.width) * data.num_components;
+            if (desired == 4 && nc != 4) {
+                const auto  channels = static_cast<unsigned int>(nc);
+                PooledBlock expanded = allocate_pooled(row_size * data.height);
+                for (unsigned int y = 0; y < data.height; y++) {
+                    const unsigned int row = flip ? data.height - 1 - y : y;
+                    image::expand_to_rgba8(std::span(pixels + static_cast<std::size_t>(y) * data.width * channels, data.width * channels),
+                                           channels,
+                                           std::span(static_cast<std::uint8_t *>(expanded.get()) + row * row_size, row_size));
+                }
+                data.data = std::move(expanded);
+            } else if (flip) {
+                image::flip_rows(std::span(pixels, row_size * data.height), row_size);
+            }
+            return data;
+        }
+
+        // anything but RGBA is left to stb, which returns the file's own channels for 4 when it has fewer
+        int stb_channels(const unsigned int desired) {
+            return desired == 4 ? 0 : static_cast<int>(desired);
+        }
+
+        // QOI decodes straight to the requested channels and row order, without going through stb at all
+        ImageData load_qoi(const std::span<const std::uint8_t> file, const unsigned int desired, const bool flip) {
+            const image::QoiHeader header   = image::parse_qoi_header(file);
+            const unsigned int     channels = desired != 0 ? desired : header.channels;
+
+            PooledBlock pixels = allocate_pooled(static_cast<std::size_t>(header.width) * header.height * channels);
+            image::decode_qoi(file,
+                              channels,
+                              std::span(static_cast<std::uint8_t *>(pixels.get()), static_cast<std::size_t>(header.width) * header.height * channels),
+                              flip);
+            return {std::move(pixels), header.width, header.height, channels, PixelType::U8};
+        }
 
-        stbi_set_flip_vertically_on_load_thread(true);
-        int w, h, nc;
-        data.data           = stbi_load(path.string().c_str(), &w, &h, &nc, desired_num_channels);
-        data.width          = w;
-        data.height         = h;
-        data.num_components = nc;
+        std::vector<std::uint8_t> read_binary_file(const std::filesystem::path &path) {
+            std::ifstream f(path, std::ios::in | std::ios::binary | std::ios::ate);
+            if (!f) {
+                throw std::runtime_error(std::format("Failed to open {}", path.string()));
+            }
 
-        if (data.data == nullptr) {
-            throw std::runtime_error("Failed to load texture");
+            const std::streampos      end = f.tellg();
+            std::vector<std::uint8_t> file(static_cast<std::size_t>(end));
+            f.seekg(0, std::ios::beg);
+            f.read(reinterpret_cast<char *>(file.data()), end);
+            return file;
         }
-        return data;
+    } // namespace
+
+    ImageData ImageData::load(const std::filesystem::path &path, const unsigned int desired_num_channels, const bool flip_vertically) {
+        // read up front, as which decoder to use is told by the file's signature
+        return load_from_memory(read_binary_file(path), desired_num_channels, flip_vertically);
     }
 
     ImageData ImageData::loadf(const std::filesystem::path &path, const unsigned int desired_num_channels) {
-        ImageData data {};
-        data.pixel_type = PixelType::F32;
+        const std::string file = path.string();
+        if (stbi_is_hdr(file.c_str())) {
+            stbi_set_flip_vertically_on_load_thread(false);
+            int         w, h, nc;
+            PooledBlock decoded(stbi_loadf(file.c_str(), &w, &h, &nc, static_cast<int>(desired_num_channels)));
+            if (decoded == nullptr) {
+                throw std::runtime_error("Failed to load texture");
+            }
 
-        stbi_set_flip_vertically_on_load_thread(true);
-        int w, h, nc;
-        data.data           = stbi_loadf(path.string().c_str(), &w, &h, &nc, desired_num_channels);
-        data.width          = w;
-        data.height         = h;
-        data.num_components = nc;
-        return data;
+            const unsigned int channels = desired_num_channels != 0 ? desired_num_channels : nc;
+            ImageData          data {std::move(decoded), static_cast<unsigned int>(w), static_cast<unsigned int>(h), channels, PixelType::F32};
+            const std::size_t  row_size = static_cast<std::size_t>(data.width) * data.num_components * sizeof(float);
+            image::flip_rows(std::span(static_cast<std::uint8_t *>(data.data.get()), row_size * data.height), row_size);
+            return data;
+        }
+
+        // stb would convert an 8-bit image with a pow() per channel, the kernels use a table
+        const ImageData   source   = load(path, desired_num_channels, false);
+        const std::size_t row_size = static_cast<std::size_t>(source.width) * source.num_components;
+        PooledBlock       pixels   = allocate_pooled(row_size * source.height * sizeof(float));
+        for (unsigned int y = 0; y < source.height; y++) {
+            image::u8_to_float(std::span(static_cast<const std::uint8_t *>(source.data.get()) + y * row_size, row_size),
+                               std::span(static_cast<float *>(pixels.get()) + (source.height - 1 - y) * row_size, row_size),
+                               source.num_components,
+                               true);
+        }
+        return {std::move(pixels), source.width, source.height, source.num_components, PixelType::F32};
+    }
+
+    ImageData ImageData::load_from_memory(const std::span<const std::uint8_t> encoded,
+                                          const unsigned int                  desired_num_channels,
+                                          const bool                          flip_vertically) {
+        if (image::is_qoi(encoded)) {
+            return load_qoi(encoded, desired_num_channels, flip_vertically);
+        }
+
+        stbi_set_flip_vertically_on_load_thread(false);
+        int         w, h, nc;
+        PooledBlock decoded(
+            stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &w, &h, &nc, stb_channels(desired_num_channels)));
+        return finish_load(std::move(decoded), w, h, nc, desired_num_channels, flip_vertically);
     }
 
-    Texture::Texture(Type type) : m_Type(type) {
+    // sampling state lives in (shared) sampler objects rather than in the texture's own parameters
+    Texture::Texture(Type type) : m_Type(type), m_Sampler(SamplerCache::get().get_sampler(default_sampler_description())) {
         glCreateTextures(static_cast<GLenum>(type), 1, &m_Texture);
-        glTextureParameteri(m_Texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTextureParameteri(m_Texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-        glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-        glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_BORDER);
     }
 
-    Texture::Texture(const unsigned int handle) : m_Texture(handle) {
+    Texture::Texture(const unsigned int handle) : m_Texture(handle), m_Sampler(SamplerCache::get().get_sampler(default_sampler_description())) {
         glGetTextureParameteriv(
             m_Texture, GL_TEXTURE_TARGET, reinterpret_cast<GLint *>(&m_Type)); // magic (not really, just querying the texture about what it is
     }
 
-    Texture::Texture(const unsigned int handle, const Type type) : m_Type(type), m_Texture(handle) {}
+    Texture::Texture(const unsigned int handle, const Type type)
+        : m_Type(type), m_Texture(handle), m_Sampler(SamplerCache::get().get_sampler(default_sampler_description())) {}
+
+    Texture::~Texture() {
+        total_texture_memory -= m_MemorySize;
+        BarrierTracker::get().forget(get_resource());
+        StateCache::get().on_texture_deleted(m_Texture);
+        glDeleteTextures(1, &m_Texture);
+    }
 
     std::vector<Texture *> Texture::create_many(const Type type, const std::size_t count) {
         std::vector<unsigned int> handles(count, 0);
@@ -348,64 +855,354 @@ namespace game::render {
                 throw std::invalid_argument("Invalid pixel type");
             }
         }
+
+        // the internal format an image is stored as, and the client format its data is in
+        std::pair<GLint, GLenum> upload_formats(const ImageData &image_data) {
+            switch (image_data.num_components) {
+            case 1:
+                return {ifmt_r(image_data.pixel_type, image_data.preserve_int), GL_RED};
+            case 2:
+                return {ifmt_rg(image_data.pixel_type, image_data.preserve_int), GL_RG};
+            case 3:
+                return {ifmt_rgb(image_data.pixel_type, image_data.preserve_int), GL_RGB};
+            case 4:
+                return {ifmt_rgba(image_data.pixel_type, image_data.preserve_int), GL_RGBA};
+            default:
+                throw std::invalid_argument("Bad image data (invalid number of channels).");
+            }
+        }
     } // namespace
 
     void Texture::set_image_2d(const ImageData &image_data) {
-        glBindTexture(GL_TEXTURE_2D, m_Texture);
-        GLint  ifmt;
-        GLenum fmt;
-        switch (image_data.num_components) {
-        case 1:
-            fmt  = GL_RED;
-            ifmt = ifmt_r(image_data.pixel_type, image_data.preserve_int);
-            break;
-        case 2:
-            fmt  = GL_RG;
-            ifmt = ifmt_rg(image_data.pixel_type, image_data.preserve_int);
-            break;
-        case 3:
-            fmt  = GL_RGB;
-            ifmt = ifmt_rgb(image_data.pixel_type, image_data.preserve_int);
-            break;
-        case 4:
-            fmt  = GL_RGBA;
-            ifmt = ifmt_rgba(image_data.pixel_type, image_data.preserve_int);
-            break;
-        default:
-            throw std::invalid_argument("Bad image data (invalid number of channels).");
-        }
+        BarrierTracker::get().read(get_resource(), BarrierTracker::Access::TextureUpdate);
+        bind();
+        const auto [ifmt, fmt] = upload_formats(image_data);
 
         glTexImage2D(
-            GL_TEXTURE_2D, 0, ifmt, image_data.width, image_data.height, 0, fmt, static_cast<GLenum>(image_data.pixel_type), image_data.data);
+            GL_TEXTURE_2D, 0, ifmt, image_data.width, image_data.height, 0, fmt, static_cast<GLenum>(image_data.pixel_type), image_data.data.get());
+        set_layout(image_data.width, image_data.height, static_cast<Format>(ifmt), 1);
+    }
+
+    void Texture::set_image_2d(const image::CompressedImageView &compressed) {
+        const Format format = to_format(compressed.format);
+        set_image_2d(compressed.width, compressed.height, format, compressed.levels);
+
+        std::size_t offset = 0;
+        for (unsigned int level = 0; level < compressed.levels; level++) {
+            const unsigned int width  = image::mip_extent(compressed.width, level);
+            const unsigned int height = image::mip_extent(compressed.height, level);
+            const std::size_t  size   = image_size(format, width, height);
+
+            glCompressedTextureSubImage2D(m_Texture,
+                                          static_cast<GLint>(level),
+                                          0,
+                                          0,
+                                          static_cast<GLsizei>(width),
+                                          static_cast<GLsizei>(height),
+                                          static_cast<GLenum>(format),
+                                          static_cast<GLsizei>(size),
+                                          compressed.data.data() + offset);
+            offset += size;
+        }
+    }
+
+    void Texture::set_layer(const unsigned int layer, const ImageData &image_data) {
+        const auto [ifmt, fmt] = upload_formats(image_data);
+        if (m_Type != Type::Texture2DArray || layer >= m_Layers) {
+            throw std::out_of_range("Layer outside the array texture");
+        }
+        if (image_data.width != m_Width || image_data.height != m_Height || static_cast<Format>(ifmt) != m_Format) {
+            throw std::invalid_argument("Image doesn't match the array texture's size or format");
+        }
+
+        BarrierTracker::get().read(get_resource(), BarrierTracker::Access::TextureUpdate);
+        glTextureSubImage3D(m_Texture,
+                            0,
+                            0,
+                            0,
+                            static_cast<GLint>(layer),
+                            static_cast<GLsizei>(m_Width),
+                            static_cast<GLsizei>(m_Height),
+                            1,
+                            fmt,
+                            static_cast<GLenum>(image_data.pixel_type),
+                            image_data.data.get());
+    }
+
+    void Texture::set_layer(const unsigned int layer, const image::CompressedImageView &compressed) {
+        const Format format = to_format(compressed.format);
+        if (m_Type != Type::Texture2DArray || layer >= m_Layers) {
+            throw std::out_of_range("Layer outside the array texture");
+        }
+        if (compressed.width != m_Width || compressed.height != m_Height || format != m_Format || compressed.levels < m_Levels) {
+            throw std::invalid_argument("Image doesn't match the array texture's size, format or levels");
+        }
+
+        BarrierTracker::get().read(get_resource(), BarrierTracker::Access::TextureUpdate);
+        std::size_t offset = 0;
+        for (unsigned int level = 0; level < m_Levels; level++) {
+            const unsigned int width  = image::mip_extent(compressed.width, level);
+            const unsigned int height = image::mip_extent(compressed.height, level);
+            const std::size_t  size   = image_size(format, width, height);
+
+            glCompressedTextureSubImage3D(m_Texture,
+                                          static_cast<GLint>(level),
+                                          0,
+                                          0,
+                                          static_cast<GLint>(layer),
+                                          static_cast<GLsizei>(width),
+                                          static_cast<GLsizei>(height),
+                                          1,
+                                          static_cast<GLenum>(format),
+                                          static_cast<GLsizei>(size),
+                                          compressed.data.data() + offset);
+            offset += size;
+        }
     }
 
     void Texture::bind() const {
-        glBindTexture(static_cast<GLenum>(m_Type), m_Texture);
+        // nothing ever changes the active texture unit, so binding to unit 0 is the same as binding to the active unit
+        StateCache::get().bind_texture(0, m_Texture);
     }
 
     void Texture::bind_unit(const unsigned int unit) const {
         // TODO: some kind of fancy assert here that bases on some globally collected limit info (i.e. a kind of assert macro formed like:
         // assert_below_limit(MAX_COMBINED_TEXTURE_IMAGE_UNITS, unit);
 
-        glActiveTexture(GL_TEXTURE0 + unit);
-        glBindTexture(static_cast<GLenum>(m_Type), m_Texture);
+        bind_unit(unit, *m_Sampler);
     }
 
-    std::shared_ptr<Texture> Texture::load(const std::filesystem::path &path) {
-        ImageData image_data = ImageData::load(path);
-        auto      texture    = std::make_shared<Texture>(Type::Texture2D);
-        texture->set_image_2d(image_data);
-        stbi_image_free(image_data.data);
-        return texture;
+    void Texture::bind_unit(const unsigned int unit, const Sampler &sampler) const {
+        BarrierTracker::get().read(get_resource(), BarrierTracker::Access::TextureFetch);
+        StateCache::get().bind_texture(unit, m_Texture);
+        sampler.bind(unit);
+    }
+
+    void Texture::set_sampler(const SamplerDescription &description) {
+        m_Sampler = SamplerCache::get().get_sampler(description);
+    }
+
+    void Texture::set_sampler(const std::shared_ptr<const Sampler> &sampler) {
+        m_Sampler = sampler;
+    }
+
+    const std::shared_ptr<const Sampler> &Texture::get_sampler() const noexcept {
+        return m_Sampler;
+    }
+
+    SamplerDescription Texture::default_sampler_description() {
+        return {.min_filter = Filter::Linear,
+                .mag_filter = Filter::Nearest,
+                .wrap_s     = WrapMode::ClampToBorder,
+                .wrap_t     = WrapMode::ClampToBorder,
+                .wrap_r     = WrapMode::ClampToBorder};
+    }
+
+    void Texture::bind_image(const unsigned int unit, const ShaderAccess access, const Format format, const int level) const {
+        const bool layered = m_Type == Type::Texture1DArray || m_Type == Type::Texture2DArray || m_Type == Type::Texture3D ||
+                             m_Type == Type::TextureCubeMap || m_Type == Type::TextureCubeMapArray || m_Type == Type::Texture2DMSArray;
+
+        auto &tracker = BarrierTracker::get();
+        tracker.read(get_resource(), BarrierTracker::Access::ShaderImage);
+        tracker.bind({BarrierTracker::Binding::Point::Image, unit}, get_resource(), access != ShaderAccess::ReadOnly);
+
+        StateCache::get().bind_image(unit, m_Texture, level, layered, 0, static_cast<GLenum>(access), static_cast<GLenum>(format));
+    }
+
+    void Texture::bind_image_layer(const unsigned int unit, const ShaderAccess access, const Format format, const int layer, const int level) const {
+        auto &tracker = BarrierTracker::get();
+        tracker.read(get_resource(), BarrierTracker::Access::ShaderImage);
+        tracker.bind({BarrierTracker::Binding::Point::Image, unit}, get_resource(), access != ShaderAccess::ReadOnly);
+
+        StateCache::get().bind_image(unit, m_Texture, level, false, layer, static_cast<GLenum>(access), static_cast<GLenum>(format));
+    }
+
+    void Texture::unbind_image(const unsigned int unit) {
+        BarrierTracker::get().unbind({BarrierTracker::Binding::Point::Image, unit});
+        StateCache::get().bind_image(unit, 0, 0, false, 0, GL_READ_ONLY, GL_RGBA8);
+    }
+
+    namespace {
+        std::shared_ptr<Texture> create_texture(const image::CompressedImageView &compressed) {
+            auto texture = std::make_shared<Texture>(Texture::Type::Texture2D);
+            texture->set_image_2d(compressed);
+            if (compressed.levels > 1) {
+                texture->set_sampler(SamplerDescription::trilinear(WrapMode::ClampToEdge));
+            }
+            return texture;
+        }
+
+        std::shared_ptr<Texture> create_texture(const ImageData &image_data, const bool mipmaps) {
+            auto texture = std::make_shared<Texture>(Texture::Type::Texture2D);
+            texture->set_image_2d(image_data);
+
+            if (mipmaps) {
+                texture->generate_mipmaps();
+                texture->set_sampler(SamplerDescription::trilinear(WrapMode::ClampToEdge));
+            }
+            return texture;
+        }
+    } // namespace
+
+    std::shared_ptr<Texture> Texture::load(const std::filesystem::path &path, const bool mipmaps) {
+        if (path.extension() == ".dds") {
+            return create_texture(image::load_dds(path).view());
+        }
+        // expanded to RGBA here rather than by the driver during the upload
+        return create_texture(ImageData::load(path, 4), mipmaps);
+    }
+
+    std::shared_ptr<Texture> Texture::load(const AssetPack &pack, const std::string_view path, const bool mipmaps) {
+        return load_from_memory(pack.get(path), mipmaps);
+    }
+
+    std::shared_ptr<Texture> Texture::load_from_memory(const std::span<const std::uint8_t> file, const bool mipmaps) {
+        if (image::is_dds(file)) {
+            return create_texture(image::parse_dds_view(file));
+        }
+        return create_texture(ImageData::load_from_memory(file, 4), mipmaps);
     }
 
     unsigned int Texture::get_handle() const noexcept {
         return m_Texture;
     }
 
-    void Texture::set_image_2d(const unsigned int width, const unsigned int height, const Format format) {
+    BarrierTracker::Resource Texture::get_resource() const noexcept {
+        return {BarrierTracker::Resource::Kind::Texture, m_Texture};
+    }
+
+    void Texture::set_image_2d(const unsigned int width, const unsigned int height, const Format format, const unsigned int levels) {
+        BarrierTracker::get().read(get_resource(), BarrierTracker::Access::TextureUpdate);
         bind();
-        glTexImage2D(static_cast<GLenum>(m_Type), 0, static_cast<GLint>(format), width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        for (unsigned int level = 0; level < levels; level++) {
+            const unsigned int level_width  = image::mip_extent(width, level);
+            const unsigned int level_height = image::mip_extent(height, level);
+
+            if (is_compressed(format)) {
+                // with no data the format/type pair of glTexImage2D is still validated, which compressed formats don't have
+                glCompressedTexImage2D(static_cast<GLenum>(m_Type),
+                                       static_cast<GLint>(level),
+                                       static_cast<GLenum>(format),
+                                       static_cast<GLsizei>(level_width),
+                                       static_cast<GLsizei>(level_height),
+                                       0,
+                                       static_cast<GLsizei>(image_size(format, level_width, level_height)),
+                                       nullptr);
+            } else {
+                glTexImage2D(static_cast<GLenum>(m_Type),
+                             static_cast<GLint>(level),
+                             static_cast<GLint>(format),
+                             level_width,
+                             level_height,
+                             0,
+                             GL_RGBA,
+                             GL_UNSIGNED_BYTE,
+                             nullptr);
+            }
+        }
+
+        // a mutable texture is only complete (and samples at all with a mipmapped filter) if every level up to the max level is defined
+        glTextureParameteri(m_Texture, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels) - 1);
+        set_layout(width, height, format, levels);
+    }
+
+    void Texture::set_storage_2d(const unsigned int width, const unsigned int height, const Format format, const unsigned int levels) {
+        glTextureStorage2D(
+            m_Texture, static_cast<GLsizei>(levels), static_cast<GLenum>(format), static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+        set_layout(width, height, format, levels);
+    }
+
+    void Texture::set_storage_2d_array(
+        const unsigned int width, const unsigned int height, const unsigned int layers, const Format format, const unsigned int levels) {
+        if (m_Type != Type::Texture2DArray) {
+            throw std::logic_error("Only 2D array textures have layers");
+        }
+        glTextureStorage3D(m_Texture,
+                           static_cast<GLsizei>(levels),
+                           static_cast<GLenum>(format),
+                           static_cast<GLsizei>(width),
+                           static_cast<GLsizei>(height),
+                           static_cast<GLsizei>(layers));
+        set_layout(width, height, format, levels, layers);
+    }
+
+    void Texture::set_storage_2d_multisample(const unsigned int width, const unsigned int height, const Format format, const unsigned int samples) {
+        if (m_Type != Type::Texture2DMS) {
+            throw std::logic_error("Only multisample textures have samples");
+        }
+        // fixed sample locations, so textures and renderbuffers can be mixed in one framebuffer
+        glTextureStorage2DMultisample(m_Texture,
+                                      static_cast<GLsizei>(samples),
+                                      static_cast<GLenum>(format),
+                                      static_cast<GLsizei>(width),
+                                      static_cast<GLsizei>(height),
+                                      GL_TRUE);
+        set_layout(width, height, format, 1, 1, samples);
+    }
+
+    void Texture::generate_mipmaps() {
+        BarrierTracker::get().read(get_resource(), BarrierTracker::Access::TextureUpdate);
+        glGenerateTextureMipmap(m_Texture);
+
+        // generating defines the levels up to the max level, all of them unless set_image_2d limited it
+        GLint max_level;
+        glGetTextureParameteriv(m_Texture, GL_TEXTURE_MAX_LEVEL, &max_level);
+        set_layout(
+            m_Width, m_Height, m_Format, std::min(image::mip_level_count(m_Width, m_Height), static_cast<unsigned int>(max_level) + 1), m_Layers);
+    }
+
+    namespace {
+        // copies `levels` levels of a 2D texture, starting at `first` in the source and at 0 in the destination
+        void copy_levels(const unsigned int source,
+                         const unsigned int first,
+                         const unsigned int destination,
+                         const unsigned int width,
+                         const unsigned int height,
+                         const unsigned int levels) {
+            for (unsigned int level = 0; level < levels; level++) {
+                glCopyImageSubData(source,
+                                   GL_TEXTURE_2D,
+                                   static_cast<GLint>(first + level),
+                                   0,
+                                   0,
+                                   0,
+                                   destination,
+                                   GL_TEXTURE_2D,
+                                   static_cast<GLint>(level),
+                                   0,
+                                   0,
+                                   0,
+                                   static_cast<GLsizei>(image::mip_extent(width, level)),
+                                   static_cast<GLsizei>(image::mip_extent(height, level)),
+                                   1);
+            }
+        }
+    } // namespace
+
+    void Texture::drop_top_levels(unsigned int count) {
+        if (m_Type != Type::Texture2D) {
+            throw std::logic_error("Only 2D textures can drop levels");
+        }
+        if (m_Levels <= 1 || (count = std::min(count, m_Levels - 1)) == 0) {
+            return;
+        }
+
+        const unsigned int width  = image::mip_extent(m_Width, count);
+        const unsigned int height = image::mip_extent(m_Height, count);
+        const unsigned int levels = m_Levels - count;
+
+        // respecifying at the smaller size discards the contents, so the kept levels take a round trip through a temporary texture
+        unsigned int kept;
+        glCreateTextures(GL_TEXTURE_2D, 1, &kept);
+        glTextureStorage2D(
+            kept, static_cast<GLsizei>(levels), static_cast<GLenum>(m_Format), static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+
+        BarrierTracker::get().read(get_resource(), BarrierTracker::Access::TextureUpdate);
+        copy_levels(m_Texture, count, kept, width, height, levels);
+        set_image_2d(width, height, m_Format, levels);
+        copy_levels(kept, 0, m_Texture, width, height, levels);
+
+        glDeleteTextures(1, &kept);
     }
 
     std::shared_ptr<Texture> Texture::create_2d(const unsigned int width, const unsigned int height, const Format format) {
@@ -414,6 +1211,36 @@ namespace game::render {
         return texture;
     }
 
+    std::size_t Texture::get_memory_size() const noexcept {
+        return m_MemorySize;
+    }
+
+    std::size_t Texture::get_total_memory_size() noexcept {
+        return total_texture_memory;
+    }
+
+    void Texture::set_layout(const unsigned int width,
+                             const unsigned int height,
+                             const Format       format,
+                             const unsigned int levels,
+                             const unsigned int layers,
+                             const unsigned int samples) {
+        std::size_t size = 0;
+        for (unsigned int level = 0; level < levels; level++) {
+            size += image_size(format, image::mip_extent(width, level), image::mip_extent(height, level));
+        }
+        size *= static_cast<std::size_t>(layers) * samples;
+
+        total_texture_memory += size - m_MemorySize;
+        m_MemorySize = size;
+        m_Width      = width;
+        m_Height     = height;
+        m_Format     = format;
+        m_Levels     = levels;
+        m_Layers     = layers;
+        m_Samples    = samples;
+    }
+
     RenderBuffer::RenderBuffer(const unsigned int width, const unsigned int height, const Format format) {
         glCreateRenderbuffers(1, &m_Handle);
         glNamedRenderbufferStorage(m_Handle, static_cast<GLenum>(format), width, height);
@@ -437,23 +1264,50 @@ namespace game::render {
     }
 
     Framebuffer::~Framebuffer() {
+        StateCache::get().on_framebuffer_deleted(m_Handle);
         glDeleteFramebuffers(1, &m_Handle);
     }
 
-    void Framebuffer::color_attachment(const Texture *const texture, const unsigned int index, const int level) const {
+    void Framebuffer::color_attachment(const Texture *const texture, const unsigned int index, const int level) {
         glNamedFramebufferTexture(m_Handle, GL_COLOR_ATTACHMENT0 + index, texture->get_handle(), level);
+        track_attachment(GL_COLOR_ATTACHMENT0 + index, texture);
     }
 
-    void Framebuffer::attachment(const Texture *texture, const Attachment attachment, const int level) const {
+    void Framebuffer::attachment(const Texture *texture, const Attachment attachment, const int level) {
         glNamedFramebufferTexture(m_Handle, static_cast<GLenum>(attachment), texture->get_handle(), level);
+        track_attachment(static_cast<GLenum>(attachment), texture);
+        set_depth_stencil_attachment(static_cast<GLenum>(attachment));
+    }
+
+    void Framebuffer::color_attachment(const RenderBuffer *texture, const unsigned int index, const int level) {
+        glNamedFramebufferRenderbuffer(m_Handle, GL_COLOR_ATTACHMENT0 + index, GL_RENDERBUFFER, texture->get_handle());
+        untrack_attachment(GL_COLOR_ATTACHMENT0 + index);
+    }
+
+    void Framebuffer::attachment(const RenderBuffer *texture, const Attachment attachment, const int level) {
+        glNamedFramebufferRenderbuffer(m_Handle, static_cast<GLenum>(attachment), GL_RENDERBUFFER, texture->get_handle());
+        untrack_attachment(static_cast<GLenum>(attachment));
+        set_depth_stencil_attachment(static_cast<GLenum>(attachment));
+    }
+
+    void Framebuffer::track_attachment(const GLenum attachment_point, const Texture *texture) {
+        untrack_attachment(attachment_point);
+        m_TextureAttachments.emplace_back(attachment_point, texture->get_handle());
     }
 
-    void Framebuffer::color_attachment(const RenderBuffer *texture, const unsigned int index, const int level) const {
-        glNamedFramebufferRenderbuffer(m_Handle, GL_COLOR_ATTACHMENT0 + index, texture->get_handle(), level);
+    void Framebuffer::untrack_attachment(const GLenum attachment_point) {
+        std::erase_if(m_TextureAttachments, [&](const auto &attachment) { return attachment.first == attachment_point; });
     }
 
-    void Framebuffer::attachment(const RenderBuffer *texture, const Attachment attachment, const int level) const {
-        glNamedFramebufferRenderbuffer(m_Handle, static_cast<GLenum>(attachment), texture->get_handle(), level);
+    void Framebuffer::set_depth_stencil_attachment(const GLenum attachment_point) {
+        if (attachment_point == GL_DEPTH_STENCIL_ATTACHMENT ||
+            (attachment_point == GL_DEPTH_ATTACHMENT && m_DepthStencilAttachment == GL_STENCIL_ATTACHMENT) ||
+            (attachment_point == GL_STENCIL_ATTACHMENT && m_DepthStencilAttachment == GL_DEPTH_ATTACHMENT)) {
+            m_DepthStencilAttachment = GL_DEPTH_STENCIL_ATTACHMENT;
+        } else if ((attachment_point == GL_DEPTH_ATTACHMENT || attachment_point == GL_STENCIL_ATTACHMENT) &&
+                   m_DepthStencilAttachment == GL_NONE) {
+            m_DepthStencilAttachment = attachment_point;
+        }
     }
 
     unsigned int Framebuffer::get_handle() const noexcept {
@@ -465,18 +1319,65 @@ namespace game::render {
     }
 
     void Framebuffer::bind() const {
-        glBindFramebuffer(GL_FRAMEBUFFER, m_Handle);
+        auto &tracker = BarrierTracker::get();
+        for (const auto &[attachment_point, texture] : m_TextureAttachments) {
+            tracker.write({BarrierTracker::Resource::Kind::Texture, texture}, BarrierTracker::Write::Framebuffer);
+        }
+
+        StateCache::get().bind_framebuffer(GL_FRAMEBUFFER, m_Handle);
     }
 
     void Framebuffer::bind_draw() const {
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_Handle);
+        auto &tracker = BarrierTracker::get();
+        for (const auto &[attachment_point, texture] : m_TextureAttachments) {
+            tracker.write({BarrierTracker::Resource::Kind::Texture, texture}, BarrierTracker::Write::Framebuffer);
+        }
+
+        StateCache::get().bind_framebuffer(GL_DRAW_FRAMEBUFFER, m_Handle);
     }
 
     void Framebuffer::bind_read() const {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_Handle);
+        auto &tracker = BarrierTracker::get();
+        for (const auto &[attachment_point, texture] : m_TextureAttachments) {
+            tracker.read({BarrierTracker::Resource::Kind::Texture, texture}, BarrierTracker::Access::Framebuffer);
+        }
+
+        StateCache::get().bind_framebuffer(GL_READ_FRAMEBUFFER, m_Handle);
     }
 
     void Framebuffer::bind_default() {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        StateCache::get().bind_framebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void Framebuffer::blit(const Framebuffer &destination, const unsigned int width, const unsigned int height, const GLbitfield mask) const {
+        auto &tracker = BarrierTracker::get();
+        for (const auto &[attachment_point, texture] : m_TextureAttachments) {
+            tracker.read({BarrierTracker::Resource::Kind::Texture, texture}, BarrierTracker::Access::Framebuffer);
+        }
+        for (const auto &[attachment_point, texture] : destination.m_TextureAttachments) {
+            tracker.write({BarrierTracker::Resource::Kind::Texture, texture}, BarrierTracker::Write::Framebuffer);
+        }
+
+        const auto w = static_cast<GLint>(width);
+        const auto h = static_cast<GLint>(height);
+        glBlitNamedFramebuffer(m_Handle, destination.m_Handle, 0, 0, w, h, 0, 0, w, h, mask, GL_NEAREST);
+    }
+
+    void Framebuffer::begin_pass(const RenderPassActions &actions) const {
+        bind();
+        load_attachments(m_Handle, actions, m_DepthStencilAttachment);
+    }
+
+    void Framebuffer::end_pass(const RenderPassActions &actions) const {
+        store_attachments(m_Handle, actions, m_DepthStencilAttachment);
+    }
+
+    void Framebuffer::begin_default_pass(const RenderPassActions &actions) {
+        bind_default();
+        load_attachments(0, actions, GL_DEPTH_STENCIL_ATTACHMENT);
+    }
+
+    void Framebuffer::end_default_pass(const RenderPassActions &actions) {
+        store_attachments(0, actions, GL_DEPTH_STENCIL_ATTACHMENT);
     }
 } // namespace game::render
@@ -8,10 +8,20 @@
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string_view>
+#include <vector>
 
+#include "game/block_pool.hpp"
 #include "game/exception.hpp"
+#include "game/image/dds.hpp"
+#include "game/render/barrier_tracker.hpp"
+#include "game/render/sampler.hpp"
+
+namespace game {
+    class AssetPack;
+}
 
 namespace game::render {
     void clearBackground();
@@ -21,6 +31,13 @@ namespace game::render {
         clearBackground({color, 1.0f});
     };
 
+    // How a shader accesses an image or storage buffer binding.
+    enum class ShaderAccess : GLenum {
+        ReadOnly  = GL_READ_ONLY,
+        WriteOnly = GL_WRITE_ONLY,
+        ReadWrite = GL_READ_WRITE,
+    };
+
     class Buffer {
       public:
         enum class Target : GLenum {
@@ -40,6 +57,14 @@ namespace game::render {
             DrawIndirect      = GL_DRAW_INDIRECT_BUFFER,
         };
 
+        // Targets with an array of indexed binding points, for use with bind_base and bind_range.
+        enum class IndexedTarget : GLenum {
+            Uniform           = GL_UNIFORM_BUFFER,
+            ShaderStorage     = GL_SHADER_STORAGE_BUFFER,
+            AtomicCounter     = GL_ATOMIC_COUNTER_BUFFER,
+            TransformFeedback = GL_TRANSFORM_FEEDBACK_BUFFER,
+        };
+
         enum class Usage : GLenum {
             StaticDraw = GL_STATIC_DRAW,
             StaticRead = GL_STATIC_READ,
@@ -60,14 +85,38 @@ namespace game::render {
 
         ~Buffer();
 
+        Buffer(const Buffer &)            = delete;
+        Buffer &operator=(const Buffer &) = delete;
+
         void bind(Target target) const;
 
+        // `access` is only meaningful for shader storage and atomic counter targets, anything else is never written by shaders.
+        void bind_base(IndexedTarget target, unsigned int index, ShaderAccess access = ShaderAccess::ReadWrite) const;
+        void bind_range(IndexedTarget target,
+                        unsigned int  index,
+                        size_t        offset,
+                        size_t        size,
+                        ShaderAccess  access = ShaderAccess::ReadWrite) const;
+
+        static void unbind_base(IndexedTarget target, unsigned int index);
+
         [[nodiscard]] unsigned int get_handle() const;
 
+        [[nodiscard]] BarrierTracker::Resource get_resource() const noexcept;
+
       private:
         unsigned int m_Buffer;
     };
 
+    // The attribute format of a vertex array: for each vertex buffer binding, the component count of each (float) attribute it holds, in order.
+    struct VertexLayout {
+        std::vector<std::vector<std::size_t>> buffers;
+
+        bool operator==(const VertexLayout &other) const = default;
+
+        [[nodiscard]] std::size_t hash() const noexcept;
+    };
+
     class VertexArray {
       public:
         VertexArray();
@@ -75,13 +124,26 @@ namespace game::render {
 
         void bind() const;
 
+        [[nodiscard]] unsigned int get_handle() const noexcept;
+
         void add_vertex_buffer(const Buffer *buffer, const std::vector<size_t> &attributes);
         void set_element_buffer(const Buffer *buffer);
 
+        [[nodiscard]] const VertexLayout &get_layout() const noexcept;
+        // hash of the layout, kept up to date so draws can be checked against their pipeline cheaply
+        [[nodiscard]] std::size_t get_layout_hash() const noexcept;
+
       private:
         unsigned int m_VertexArray;
         unsigned int m_NextBinding   = 0;
         unsigned int m_NextAttribute = 0;
+
+        // kept so binding the vertex array can wait on pending shader writes to its buffers
+        std::vector<unsigned int> m_VertexBuffers;
+        unsigned int              m_ElementBuffer = 0;
+
+        VertexLayout m_Layout;
+        std::size_t  m_LayoutHash = 0;
     };
 
     class ShaderModule {
@@ -106,11 +168,14 @@ namespace game::render {
         Type         m_Type;
     };
 
-    // TODO: redo shader abstraction as a pipeline abstraction for better compatibility with trying to port this to use vulkan in the future (not
-    // important right now)
+    // Draws go through Pipeline (pipeline.hpp), which bundles a program with the fixed-function state it's used with.
     class ShaderProgram {
       public:
         explicit ShaderProgram(const std::vector<ShaderModule *> &modules);
+        ~ShaderProgram();
+
+        ShaderProgram(const ShaderProgram &)            = delete;
+        ShaderProgram &operator=(const ShaderProgram &) = delete;
 
         static std::shared_ptr<ShaderProgram>
         create(const std::vector<ShaderModule *> &modules); // works unlike a call to std::make_shared<ShaderProgram>({module1, module2}) would.
@@ -121,9 +186,14 @@ namespace game::render {
         static std::shared_ptr<ShaderProgram> load(const std::filesystem::path &vertex_path, const std::filesystem::path &fragment_path);
         static std::shared_ptr<ShaderProgram> load_compute(const std::filesystem::path &compute_path);
         static std::shared_ptr<ShaderProgram> load(const std::vector<std::pair<ShaderModule::Type, std::filesystem::path>> &paths);
+        // compiles the sources straight from the pack's mapping
+        static std::shared_ptr<ShaderProgram> load(const AssetPack                                                  &pack,
+                                                   const std::vector<std::pair<ShaderModule::Type, std::string_view>> &paths);
 
         void use() const;
 
+        [[nodiscard]] unsigned int get_handle() const noexcept;
+
         [[nodiscard]] int get_uniform_location(std::string_view name) const;
 
         void uniform1i(std::string_view name, int value) const;
@@ -191,8 +261,28 @@ namespace game::render {
 
         S8  = GL_STENCIL_INDEX8,
         S16 = GL_STENCIL_INDEX16,
+
+        // block-compressed, sampled only (no rendering or image access)
+        BC1      = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+        BC1_SRGB = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
+        BC3      = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+        BC3_SRGB = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,
+
+        BC4       = GL_COMPRESSED_RED_RGTC1,
+        BC4_SNORM = GL_COMPRESSED_SIGNED_RED_RGTC1,
+        BC5       = GL_COMPRESSED_RG_RGTC2,
+        BC5_SNORM = GL_COMPRESSED_SIGNED_RG_RGTC2,
+
+        BC7      = GL_COMPRESSED_RGBA_BPTC_UNORM,
+        BC7_SRGB = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
     };
 
+    [[nodiscard]] bool   is_compressed(Format format);
+    [[nodiscard]] Format to_format(image::BlockFormat format);
+
+    // Bytes a width x height image in `format` takes, ignoring whatever padding the driver adds.
+    [[nodiscard]] std::size_t image_size(Format format, unsigned int width, unsigned int height);
+
     enum class PixelType {
         I8  = GL_BYTE,
         U8  = GL_UNSIGNED_BYTE,
@@ -204,15 +294,21 @@ namespace game::render {
     };
 
     struct ImageData {
-        void        *data;
+        // from the decoding thread's block pool, which stb allocates from as well
+        PooledBlock  data;
         unsigned int width, height;
         unsigned int num_components;
         PixelType    pixel_type;
         bool         preserve_int = false;
 
-        // returned data block must be freed using stbi_image_free
-        static ImageData load(const std::filesystem::path &path, unsigned int desired_num_channels = 0);
+        // Rows come bottom-up as OpenGL expects them unless `flip_vertically` is off. QOI images (told apart by their signature) are decoded by
+        // the game's own decoder, to 3 or 4 channels only; everything else goes through stb_image.
+        static ImageData load(const std::filesystem::path &path, unsigned int desired_num_channels = 0, bool flip_vertically = true);
+        // 8-bit images have their colour channels decoded from sRGB to linear
         static ImageData loadf(const std::filesystem::path &path, unsigned int desired_num_channels = 0);
+        // decodes an image file held in memory
+        static ImageData
+        load_from_memory(std::span<const std::uint8_t> encoded, unsigned int desired_num_channels = 0, bool flip_vertically = true);
     };
 
     class Texture {
@@ -240,24 +336,98 @@ namespace game::render {
         explicit Texture(unsigned int handle); // use Texture(unsigned int, Type) instead unless you don't know the type of the texture already.
         Texture(unsigned int handle, Type type);
 
+        ~Texture();
+
+        Texture(const Texture &)            = delete;
+        Texture &operator=(const Texture &) = delete;
+
         static std::vector<Texture *> create_many(Type type, std::size_t count);
 
         void set_image_2d(const ImageData &image_data);
+        // (Re)specifies the texture with every level of `compressed`.
+        void set_image_2d(const image::CompressedImageView &compressed);
+
+        // Fill one layer of a 2D array texture allocated by set_storage_2d_array, which the image must match in size and format. Uncompressed
+        // images fill the base level only, compressed ones every level the texture has.
+        void set_layer(unsigned int layer, const ImageData &image_data);
+        void set_layer(unsigned int layer, const image::CompressedImageView &compressed);
 
         void bind() const;
+        // binds the texture together with its own sampler
         void bind_unit(unsigned int unit) const;
+        void bind_unit(unsigned int unit, const Sampler &sampler) const;
+
+        // The sampler bind_unit uses when not given one. Defaults to linear minification, nearest magnification and clamping to the border.
+        void set_sampler(const SamplerDescription &description);
+        void set_sampler(const std::shared_ptr<const Sampler> &sampler);
+
+        [[nodiscard]] const std::shared_ptr<const Sampler> &get_sampler() const noexcept;
 
-        static std::shared_ptr<Texture> load(const std::filesystem::path &path);
+        [[nodiscard]] static SamplerDescription default_sampler_description();
+
+        // Binds a single level of the texture to an image unit for load/store access. Array, cube and 3D textures are bound with all their layers.
+        void bind_image(unsigned int unit, ShaderAccess access, Format format, int level = 0) const;
+        // Binds one layer of a level of an array, cube or 3D texture to an image unit.
+        void bind_image_layer(unsigned int unit, ShaderAccess access, Format format, int layer, int level = 0) const;
+
+        static void unbind_image(unsigned int unit);
+
+        // With `mipmaps` the full chain is generated on the GPU and the texture gets a trilinear sampler. DDS files are uploaded still compressed
+        // with the levels they contain instead.
+        static std::shared_ptr<Texture> load(const std::filesystem::path &path, bool mipmaps = true);
+        static std::shared_ptr<Texture> load(const AssetPack &pack, std::string_view path, bool mipmaps = true);
+        // DDS files are told apart by their signature here
+        static std::shared_ptr<Texture> load_from_memory(std::span<const std::uint8_t> file, bool mipmaps = true);
 
         [[nodiscard]] unsigned int get_handle() const noexcept;
 
-        void set_image_2d(unsigned int width, unsigned int height, Format format);
+        [[nodiscard]] BarrierTracker::Resource get_resource() const noexcept;
+
+        // (Re)specifies `levels` levels with undefined contents, limiting sampling to those levels. Compressed formats are filled in with
+        // glCompressedTextureSubImage2D afterwards.
+        void set_image_2d(unsigned int width, unsigned int height, Format format, unsigned int levels = 1);
+        // Allocates immutable storage, which unlike set_image_2d also accepts depth and stencil formats. Can only be called once per texture.
+        void set_storage_2d(unsigned int width, unsigned int height, Format format, unsigned int levels = 1);
+        // Immutable storage for a 2D array texture of `layers` same-sized images, filled with set_layer.
+        void set_storage_2d_array(unsigned int width, unsigned int height, unsigned int layers, Format format, unsigned int levels = 1);
+        // Immutable storage for a multisampled texture, which can only be rendered to and resolved, never sampled with filtering.
+        void set_storage_2d_multisample(unsigned int width, unsigned int height, Format format, unsigned int samples);
+
+        // Fills every level below the base level from it (glGenerateTextureMipmap).
+        void generate_mipmaps();
+
+        // Frees the `count` largest levels of a 2D texture, reallocating it at the size of the next one while keeping its GL name, so
+        // everything referring to the texture keeps working and just samples a blurrier image. At least one level is always kept.
+        void drop_top_levels(unsigned int count);
 
         static std::shared_ptr<Texture> create_2d(unsigned int width, unsigned int height, Format format);
 
+        // Size, format and memory of the levels specified through this class; textures adopted from a handle count as empty.
+        [[nodiscard]] unsigned int get_width() const noexcept { return m_Width; }
+        [[nodiscard]] unsigned int get_height() const noexcept { return m_Height; }
+        [[nodiscard]] Format       get_format() const noexcept { return m_Format; }
+        [[nodiscard]] unsigned int get_levels() const noexcept { return m_Levels; }
+        [[nodiscard]] unsigned int get_layers() const noexcept { return m_Layers; }
+        [[nodiscard]] unsigned int get_samples() const noexcept { return m_Samples; }
+
+        [[nodiscard]] std::size_t        get_memory_size() const noexcept;
+        [[nodiscard]] static std::size_t get_total_memory_size() noexcept;
+
       private:
+        void set_layout(
+            unsigned int width, unsigned int height, Format format, unsigned int levels, unsigned int layers = 1, unsigned int samples = 1);
+
         Type         m_Type;
         unsigned int m_Texture;
+
+        unsigned int m_Width = 0, m_Height = 0;
+        Format       m_Format     = Format::RGBA8;
+        unsigned int m_Levels     = 0;
+        unsigned int m_Layers     = 1;
+        unsigned int m_Samples    = 1;
+        std::size_t  m_MemorySize = 0;
+
+        std::shared_ptr<const Sampler> m_Sampler;
     };
 
     class RenderBuffer {
@@ -272,6 +442,37 @@ namespace game::render {
         unsigned int m_Handle;
     };
 
+    // What happens to an attachment's contents when a render pass begins.
+    enum class LoadOp {
+        Load,     // keep the previous contents
+        Clear,    // clear to the attachment's clear value
+        DontCare, // contents are undefined, the pass overwrites everything it needs
+    };
+
+    // What happens to an attachment's contents when a render pass ends.
+    enum class StoreOp {
+        Store,
+        Discard, // nothing reads the contents afterwards
+    };
+
+    struct ClearValue {
+        glm::vec4 color   = glm::vec4(0.0f);
+        float     depth   = 1.0f;
+        int       stencil = 0;
+    };
+
+    struct AttachmentActions {
+        LoadOp     load  = LoadOp::Load;
+        StoreOp    store = StoreOp::Store;
+        ClearValue clear = {};
+    };
+
+    struct RenderPassActions {
+        // indexed by draw buffer, color attachments without an entry are loaded and stored
+        std::vector<AttachmentActions> color;
+        AttachmentActions              depth_stencil;
+    };
+
     class Framebuffer {
       public:
         enum class Attachment : GLenum {
@@ -316,11 +517,11 @@ namespace game::render {
         ~Framebuffer();
 
 
-        void color_attachment(const Texture *texture, unsigned int index, int level = 0) const;
-        void attachment(const Texture *texture, Attachment attachment, int level = 0) const;
+        void color_attachment(const Texture *texture, unsigned int index, int level = 0);
+        void attachment(const Texture *texture, Attachment attachment, int level = 0);
 
-        void color_attachment(const RenderBuffer *texture, unsigned int index, int level = 0) const;
-        void attachment(const RenderBuffer *texture, Attachment attachment, int level = 0) const;
+        void color_attachment(const RenderBuffer *texture, unsigned int index, int level = 0);
+        void attachment(const RenderBuffer *texture, Attachment attachment, int level = 0);
 
         [[nodiscard]] unsigned int get_handle() const noexcept;
         [[nodiscard]] bool         is_complete() const;
@@ -331,7 +532,30 @@ namespace game::render {
 
         static void bind_default();
 
+        // Copies the `mask` buffers (GL_COLOR_BUFFER_BIT etc.) of a width x height area from this framebuffer's read buffer to every draw
+        // buffer of `destination`, resolving multisampled attachments on the way. Resolving needs both to be the same size.
+        void blit(const Framebuffer &destination, unsigned int width, unsigned int height, GLbitfield mask) const;
+
+        // Binds the framebuffer and applies the load actions: cleared attachments are cleared with glClearNamedFramebuffer*, don't-care
+        // attachments are invalidated so the driver needn't preserve (or on tiled hardware, read back) their contents.
+        void begin_pass(const RenderPassActions &actions) const;
+        // Applies the store actions, invalidating discarded attachments.
+        void end_pass(const RenderPassActions &actions) const;
+
+        static void begin_default_pass(const RenderPassActions &actions);
+        static void end_default_pass(const RenderPassActions &actions);
+
       private:
+        void track_attachment(GLenum attachment_point, const Texture *texture);
+        void untrack_attachment(GLenum attachment_point);
+        void set_depth_stencil_attachment(GLenum attachment_point);
+
         unsigned int m_Handle;
+        // GL_DEPTH_ATTACHMENT, GL_STENCIL_ATTACHMENT, GL_DEPTH_STENCIL_ATTACHMENT or GL_NONE, picks the clear and invalidate calls for the depth
+        // and stencil actions
+        GLenum m_DepthStencilAttachment = GL_NONE;
+
+        // texture attachments, so binding the framebuffer for drawing can be ordered against image stores into them
+        std::vector<std::pair<GLenum, unsigned int>> m_TextureAttachments;
     };
 } // namespace game::render
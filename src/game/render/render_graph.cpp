@@ -0,0 +1,362 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/render_graph.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace game::render {
+    Texture *TransientTexturePool::acquire(const TextureDescription &description) {
+        for (auto &entry : m_Entries) {
+            if (!entry.in_use && entry.description == description) {
+                entry.in_use = true;
+                return entry.texture.get();
+            }
+        }
+
+        auto texture = std::make_shared<Texture>(Texture::Type::Texture2D);
+        texture->set_storage_2d(description.width, description.height, description.format);
+        m_Entries.push_back({description, std::move(texture), true});
+        return m_Entries.back().texture.get();
+    }
+
+    void TransientTexturePool::release(const Texture *texture) {
+        for (auto &entry : m_Entries) {
+            if (entry.texture.get() == texture) {
+                entry.in_use = false;
+                return;
+            }
+        }
+    }
+
+    void TransientTexturePool::trim() {
+        std::erase_if(m_Entries, [](const Entry &entry) { return !entry.in_use; });
+    }
+
+    RenderGraph::PassBuilder::PassBuilder(RenderGraph &graph, const std::uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+    RenderGraph::ResourceHandle RenderGraph::PassBuilder::create(std::string name, const TextureDescription &description) {
+        const ResourceHandle handle {static_cast<std::uint32_t>(m_Graph.m_Resources.size())};
+        m_Graph.m_Resources.push_back({.name = std::move(name), .description = description});
+        return handle;
+    }
+
+    void RenderGraph::PassBuilder::read(const ResourceHandle resource, const ReadUsage usage) {
+        m_Graph.resource(resource); // validates the handle
+        m_Graph.m_Passes[m_Pass].reads.push_back({resource, usage, std::nullopt});
+    }
+
+    void RenderGraph::PassBuilder::sample(const ResourceHandle resource, const SamplerDescription &sampler) {
+        m_Graph.resource(resource);
+        m_Graph.m_Passes[m_Pass].reads.push_back({resource, ReadUsage::Sampled, sampler});
+    }
+
+    void RenderGraph::PassBuilder::write(const ResourceHandle resource, const WriteUsage usage, const unsigned int color_index) {
+        if (m_Graph.resource(resource).backbuffer && usage != WriteUsage::ColorAttachment) {
+            throw std::invalid_argument("The backbuffer can only be written as a color attachment");
+        }
+
+        m_Graph.m_Passes[m_Pass].writes.push_back({resource, usage, color_index, std::nullopt});
+    }
+
+    void RenderGraph::PassBuilder::clear(const ResourceHandle resource, const ClearValue &value) {
+        for (auto &write : m_Graph.m_Passes[m_Pass].writes) {
+            if (write.resource.index == resource.index && write.usage != WriteUsage::Image) {
+                write.clear = value;
+                return;
+            }
+        }
+
+        throw std::invalid_argument(std::format("Render graph pass '{}' clears '{}' without writing it as an attachment",
+                                                m_Graph.m_Passes[m_Pass].name,
+                                                m_Graph.resource(resource).name));
+    }
+
+    void RenderGraph::PassBuilder::set_side_effect() {
+        m_Graph.m_Passes[m_Pass].side_effect = true;
+    }
+
+    RenderGraph::PassContext::PassContext(const RenderGraph &graph, const std::uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+    Texture *RenderGraph::PassContext::get_texture(const ResourceHandle resource) const {
+        return m_Graph.resource(resource).texture;
+    }
+
+    Framebuffer *RenderGraph::PassContext::get_framebuffer() const noexcept {
+        return m_Graph.m_Passes[m_Pass].framebuffer.get();
+    }
+
+    unsigned int RenderGraph::PassContext::get_width() const noexcept {
+        return m_Graph.m_Passes[m_Pass].width;
+    }
+
+    unsigned int RenderGraph::PassContext::get_height() const noexcept {
+        return m_Graph.m_Passes[m_Pass].height;
+    }
+
+    RenderGraph::RenderGraph() = default;
+
+    RenderGraph::~RenderGraph() = default;
+
+    RenderGraph::ResourceHandle RenderGraph::import_texture(std::string name, Texture *texture, const bool output) {
+        const ResourceHandle handle {static_cast<std::uint32_t>(m_Resources.size())};
+        m_Resources.push_back({.name = std::move(name), .imported = texture, .output = output});
+        m_Compiled = false;
+        return handle;
+    }
+
+    RenderGraph::ResourceHandle RenderGraph::import_backbuffer(std::string name, const unsigned int width, const unsigned int height) {
+        const ResourceHandle handle {static_cast<std::uint32_t>(m_Resources.size())};
+        m_Resources.push_back({.name = std::move(name), .description = {width, height, Format::RGBA8}, .backbuffer = true, .output = true});
+        m_Compiled = false;
+        return handle;
+    }
+
+    void RenderGraph::mark_output(const ResourceHandle resource) {
+        this->resource(resource).output = true;
+        m_Compiled                      = false;
+    }
+
+    void RenderGraph::add_pass(std::string name, const SetupFunction &setup, ExecuteFunction execute) {
+        const auto pass = static_cast<std::uint32_t>(m_Passes.size());
+        m_Passes.push_back({.name = std::move(name), .execute = std::move(execute)});
+
+        PassBuilder builder(*this, pass);
+        setup(builder);
+        m_Compiled = false;
+    }
+
+    RenderGraph::ResourceNode &RenderGraph::resource(const ResourceHandle handle) {
+        if (handle.index >= m_Resources.size()) {
+            throw std::out_of_range("Invalid render graph resource");
+        }
+        return m_Resources[handle.index];
+    }
+
+    const RenderGraph::ResourceNode &RenderGraph::resource(const ResourceHandle handle) const {
+        if (handle.index >= m_Resources.size()) {
+            throw std::out_of_range("Invalid render graph resource");
+        }
+        return m_Resources[handle.index];
+    }
+
+    void RenderGraph::compile() {
+        release_transients();
+        cull();
+        allocate();
+        create_framebuffers();
+        m_Compiled = true;
+    }
+
+    void RenderGraph::cull() {
+        // Walking backwards, a pass is needed when it writes something a later needed pass reads (or an output). Declaration order already
+        // puts producers before consumers, so one sweep is enough.
+        std::vector needed(m_Resources.size(), false);
+        for (std::size_t i = 0; i < m_Resources.size(); i++) {
+            needed[i] = m_Resources[i].output;
+        }
+
+        for (auto pass = m_Passes.rbegin(); pass != m_Passes.rend(); ++pass) {
+            const bool live = pass->side_effect || std::ranges::any_of(pass->writes, [&](const Write &write) { return needed[write.resource.index]; });
+            pass->culled    = !live;
+
+            if (live) {
+                for (const auto &read : pass->reads) {
+                    needed[read.resource.index] = true;
+                }
+            }
+        }
+    }
+
+    void RenderGraph::allocate() {
+        for (auto &resource : m_Resources) {
+            resource.first_pass = -1;
+            resource.last_pass  = -1;
+            resource.texture    = resource.imported;
+        }
+
+        for (int i = 0; i < static_cast<int>(m_Passes.size()); i++) {
+            if (m_Passes[i].culled) {
+                continue;
+            }
+
+            auto touch = [&](const ResourceHandle handle) {
+                auto &resource = m_Resources[handle.index];
+                if (resource.first_pass < 0) {
+                    resource.first_pass = i;
+                }
+                resource.last_pass = i;
+            };
+
+            for (const auto &read : m_Passes[i].reads) {
+                if (m_Resources[read.resource.index].first_pass < 0 && m_Resources[read.resource.index].imported == nullptr &&
+                    !m_Resources[read.resource.index].backbuffer) {
+                    throw std::logic_error(std::format(
+                        "Render graph pass '{}' reads '{}' before anything writes it", m_Passes[i].name, m_Resources[read.resource.index].name));
+                }
+                touch(read.resource);
+            }
+            for (const auto &write : m_Passes[i].writes) {
+                touch(write.resource);
+            }
+        }
+
+        // Hand out textures in pass order, returning each one to the pool right after its last use so that resources created later can alias
+        // it. Outputs are read after the frame, so they keep their textures until release_transients at the next compile or clear.
+        for (int i = 0; i < static_cast<int>(m_Passes.size()); i++) {
+            for (auto &resource : m_Resources) {
+                if (resource.first_pass == i && resource.imported == nullptr && !resource.backbuffer) {
+                    resource.texture = m_Pool.acquire(resource.description);
+                }
+            }
+
+            for (auto &resource : m_Resources) {
+                if (resource.last_pass == i && resource.imported == nullptr && !resource.backbuffer && !resource.output) {
+                    m_Pool.release(resource.texture);
+                }
+            }
+        }
+    }
+
+    void RenderGraph::create_framebuffers() {
+        for (int i = 0; i < static_cast<int>(m_Passes.size()); i++) {
+            auto &pass = m_Passes[i];
+            pass.framebuffer.reset();
+            pass.actions         = {};
+            pass.uses_backbuffer = false;
+            pass.width           = 0;
+            pass.height          = 0;
+
+            if (pass.culled) {
+                continue;
+            }
+
+            for (const auto &write : pass.writes) {
+                const auto &resource = m_Resources[write.resource.index];
+                if (resource.imported == nullptr) {
+                    pass.width  = resource.description.width;
+                    pass.height = resource.description.height;
+                }
+
+                if (write.usage == WriteUsage::Image) {
+                    continue;
+                }
+
+                const bool        transient = resource.imported == nullptr && !resource.backbuffer;
+                AttachmentActions actions;
+                if (write.clear.has_value()) {
+                    actions.load  = LoadOp::Clear;
+                    actions.clear = *write.clear;
+                } else if (transient && resource.first_pass == i) {
+                    actions.load = LoadOp::DontCare;
+                }
+                if (transient && resource.last_pass == i && !resource.output) {
+                    actions.store = StoreOp::Discard;
+                }
+
+                if (write.usage == WriteUsage::ColorAttachment) {
+                    if (pass.actions.color.size() <= write.color_index) {
+                        pass.actions.color.resize(write.color_index + 1);
+                    }
+                    pass.actions.color[write.color_index] = actions;
+                } else {
+                    pass.actions.depth_stencil = actions;
+                }
+
+                if (resource.backbuffer) {
+                    pass.uses_backbuffer = true;
+                    continue;
+                }
+
+                if (!pass.framebuffer) {
+                    pass.framebuffer = std::make_unique<Framebuffer>();
+                }
+
+                if (write.usage == WriteUsage::ColorAttachment) {
+                    pass.framebuffer->color_attachment(resource.texture, write.color_index);
+                } else {
+                    pass.framebuffer->attachment(resource.texture, Framebuffer::Attachment::DepthStencil);
+                }
+            }
+
+            if (pass.uses_backbuffer && pass.framebuffer) {
+                throw std::logic_error(std::format("Render graph pass '{}' mixes the backbuffer with other attachments", pass.name));
+            }
+        }
+    }
+
+    void RenderGraph::execute() {
+        if (!m_Compiled) {
+            compile();
+        }
+
+        auto &tracker = BarrierTracker::get();
+        for (std::uint32_t i = 0; i < m_Passes.size(); i++) {
+            const auto &pass = m_Passes[i];
+            if (pass.culled) {
+                continue;
+            }
+
+            for (const auto &read : pass.reads) {
+                Texture *texture = m_Resources[read.resource.index].texture;
+                if (texture == nullptr) {
+                    continue;
+                }
+
+                tracker.read(texture->get_resource(),
+                             read.usage == ReadUsage::Image ? BarrierTracker::Access::ShaderImage : BarrierTracker::Access::TextureFetch);
+                if (read.sampler.has_value()) {
+                    texture->set_sampler(*read.sampler);
+                }
+            }
+
+            if (pass.framebuffer) {
+                pass.framebuffer->begin_pass(pass.actions);
+            } else if (pass.uses_backbuffer) {
+                Framebuffer::begin_default_pass(pass.actions);
+            }
+
+            if (pass.width != 0 && pass.height != 0) {
+                glViewport(0, 0, static_cast<GLsizei>(pass.width), static_cast<GLsizei>(pass.height));
+            }
+
+            pass.execute(PassContext(*this, i));
+
+            if (pass.framebuffer) {
+                pass.framebuffer->end_pass(pass.actions);
+            } else if (pass.uses_backbuffer) {
+                Framebuffer::end_default_pass(pass.actions);
+            }
+        }
+    }
+
+    void RenderGraph::release_transients() {
+        for (auto &resource : m_Resources) {
+            if (resource.imported == nullptr && resource.texture != nullptr) {
+                m_Pool.release(resource.texture);
+                resource.texture = nullptr;
+            }
+        }
+    }
+
+    void RenderGraph::clear() {
+        m_Passes.clear();
+        release_transients();
+        m_Resources.clear();
+        m_Compiled = false;
+    }
+
+    RenderGraph::Statistics RenderGraph::get_statistics() const noexcept {
+        Statistics statistics {m_Passes.size(), 0, 0, m_Pool.get_texture_count()};
+        for (const auto &pass : m_Passes) {
+            statistics.passes_culled += pass.culled;
+        }
+        for (const auto &resource : m_Resources) {
+            statistics.transient_resources += resource.imported == nullptr && !resource.backbuffer;
+        }
+        return statistics;
+    }
+} // namespace game::render
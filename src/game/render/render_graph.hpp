@@ -0,0 +1,203 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/render/render.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace game::render {
+    struct TextureDescription {
+        unsigned int width, height;
+        Format       format;
+
+        bool operator==(const TextureDescription &other) const = default;
+    };
+
+    // Owns textures handed out for transient render graph resources. Released textures are kept and handed out again to the next request with
+    // the same description.
+    class TransientTexturePool {
+      public:
+        Texture *acquire(const TextureDescription &description);
+        void     release(const Texture *texture);
+
+        // Deletes every texture which is not currently acquired.
+        void trim();
+
+        [[nodiscard]] std::size_t get_texture_count() const noexcept { return m_Entries.size(); }
+
+      private:
+        struct Entry {
+            TextureDescription       description;
+            std::shared_ptr<Texture> texture;
+            bool                     in_use;
+        };
+
+        std::vector<Entry> m_Entries;
+    };
+
+    // Frame structure declared as passes reading and writing named resources. compile() culls passes whose results nothing uses, works out the
+    // lifetime of every transient resource and backs them with pooled textures, letting resources whose lifetimes don't overlap share a
+    // texture. execute() runs the remaining passes in declaration order, beginning each pass's framebuffer and issuing the barriers its reads
+    // depend on. Transient attachments are discarded after their last use.
+    class RenderGraph {
+      public:
+        struct ResourceHandle {
+            std::uint32_t index = ~0u;
+
+            [[nodiscard]] bool is_valid() const noexcept { return index != ~0u; }
+        };
+
+        enum class ReadUsage {
+            Sampled,
+            Image,
+        };
+
+        enum class WriteUsage {
+            ColorAttachment,
+            DepthStencilAttachment,
+            Image,
+        };
+
+        class PassBuilder {
+          public:
+            // Declares a transient resource first written by this pass.
+            ResourceHandle create(std::string name, const TextureDescription &description);
+
+            void read(ResourceHandle resource, ReadUsage usage = ReadUsage::Sampled);
+            // read with texture fetches through the given sampler, which the graph assigns to the texture before the pass runs
+            void sample(ResourceHandle resource, const SamplerDescription &sampler);
+
+            void write(ResourceHandle resource, WriteUsage usage, unsigned int color_index = 0);
+            // Clears an attachment this pass writes when the pass begins. Attachments which aren't cleared are loaded, unless this pass is the
+            // first to write a transient resource, in which case the old contents are invalidated instead.
+            void clear(ResourceHandle resource, const ClearValue &value);
+
+            // keeps the pass even if nothing reads what it writes
+            void set_side_effect();
+
+          private:
+            friend class RenderGraph;
+
+            PassBuilder(RenderGraph &graph, std::uint32_t pass);
+
+            RenderGraph  &m_Graph;
+            std::uint32_t m_Pass;
+        };
+
+        class PassContext {
+          public:
+            [[nodiscard]] Texture *get_texture(ResourceHandle resource) const;
+
+            // nullptr for passes without attachments and for passes drawing to the backbuffer
+            [[nodiscard]] Framebuffer *get_framebuffer() const noexcept;
+
+            // size of the transient resources (or the backbuffer) the pass writes, which is also what the viewport is set to
+            [[nodiscard]] unsigned int get_width() const noexcept;
+            [[nodiscard]] unsigned int get_height() const noexcept;
+
+          private:
+            friend class RenderGraph;
+
+            PassContext(const RenderGraph &graph, std::uint32_t pass);
+
+            const RenderGraph &m_Graph;
+            std::uint32_t      m_Pass;
+        };
+
+        using SetupFunction   = std::function<void(PassBuilder &)>;
+        using ExecuteFunction = std::function<void(const PassContext &)>;
+
+        struct Statistics {
+            std::size_t passes;
+            std::size_t passes_culled;
+            std::size_t transient_resources;
+            std::size_t textures_allocated;
+        };
+
+        RenderGraph();
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph &)            = delete;
+        RenderGraph &operator=(const RenderGraph &) = delete;
+
+        // Imported textures are owned by the caller and never aliased. Outputs keep the passes writing them alive.
+        ResourceHandle import_texture(std::string name, Texture *texture, bool output = false);
+        // The default framebuffer, which is always an output.
+        ResourceHandle import_backbuffer(std::string name, unsigned int width, unsigned int height);
+
+        void mark_output(ResourceHandle resource);
+
+        void add_pass(std::string name, const SetupFunction &setup, ExecuteFunction execute);
+
+        void compile();
+        void execute();
+
+        // Removes all passes and resources, returning transient textures to the pool.
+        void clear();
+
+        [[nodiscard]] Statistics get_statistics() const noexcept;
+
+      private:
+        struct ResourceNode {
+            std::string        name;
+            TextureDescription description;
+            Texture           *imported   = nullptr;
+            bool               backbuffer = false;
+            bool               output     = false;
+
+            // filled in by compile()
+            Texture *texture    = nullptr;
+            int      first_pass = -1;
+            int      last_pass  = -1;
+        };
+
+        struct Read {
+            ResourceHandle                    resource;
+            ReadUsage                         usage;
+            std::optional<SamplerDescription> sampler;
+        };
+
+        struct Write {
+            ResourceHandle            resource;
+            WriteUsage                usage;
+            unsigned int              color_index;
+            std::optional<ClearValue> clear;
+        };
+
+        struct PassNode {
+            std::string        name;
+            ExecuteFunction    execute;
+            std::vector<Read>  reads;
+            std::vector<Write> writes;
+            bool               side_effect = false;
+
+            // filled in by compile()
+            bool                         culled = false;
+            std::unique_ptr<Framebuffer> framebuffer;
+            RenderPassActions            actions;
+            bool                         uses_backbuffer = false;
+            unsigned int                 width = 0, height = 0;
+        };
+
+        ResourceNode &resource(ResourceHandle handle);
+        [[nodiscard]] const ResourceNode &resource(ResourceHandle handle) const;
+
+        void cull();
+        void allocate();
+        void create_framebuffers();
+        void release_transients();
+
+        std::vector<ResourceNode> m_Resources;
+        std::vector<PassNode>     m_Passes;
+        TransientTexturePool      m_Pool;
+        bool                      m_Compiled = false;
+    };
+} // namespace game::render
@@ -0,0 +1,248 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/render_queue.hpp"
+#include "game/render/state_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace game::render {
+    UniformValue UniformValue::of(const int location, const int value) {
+        UniformValue uniform {location, Type::Int};
+        uniform.i = value;
+        return uniform;
+    }
+
+    UniformValue UniformValue::of(const int location, const float value) {
+        UniformValue uniform {location, Type::Float};
+        uniform.f[0] = value;
+        return uniform;
+    }
+
+    UniformValue UniformValue::of(const int location, const glm::vec2 &value) {
+        UniformValue uniform {location, Type::Vec2};
+        uniform.f[0] = value.x;
+        uniform.f[1] = value.y;
+        return uniform;
+    }
+
+    UniformValue UniformValue::of(const int location, const glm::vec3 &value) {
+        UniformValue uniform {location, Type::Vec3};
+        uniform.f[0] = value.r;
+        uniform.f[1] = value.g;
+        uniform.f[2] = value.b;
+        return uniform;
+    }
+
+    UniformValue UniformValue::of(const int location, const glm::vec4 &value) {
+        UniformValue uniform {location, Type::Vec4};
+        uniform.f[0] = value.r;
+        uniform.f[1] = value.g;
+        uniform.f[2] = value.b;
+        uniform.f[3] = value.a;
+        return uniform;
+    }
+
+    namespace sort_key {
+        std::uint64_t make(const std::uint8_t pass, const unsigned int pipeline, const unsigned int texture, const unsigned int vertex_array, float depth) {
+            depth                     = std::clamp(depth, 0.0f, 1.0f);
+            const auto quantized      = static_cast<std::uint64_t>(depth * static_cast<float>((1u << depth_bits) - 1));
+            constexpr auto field_mask = [](const unsigned int bits) { return (std::uint64_t {1} << bits) - 1; };
+
+            std::uint64_t key = pass;
+            key               = key << pipeline_bits | (pipeline & field_mask(pipeline_bits));
+            key               = key << texture_bits | (texture & field_mask(texture_bits));
+            key               = key << vao_bits | (vertex_array & field_mask(vao_bits));
+            key               = key << depth_bits | (quantized & field_mask(depth_bits));
+            return key;
+        }
+    } // namespace sort_key
+
+    namespace {
+        void apply_uniform(const unsigned int program, const UniformValue &uniform) {
+            switch (uniform.type) {
+            case UniformValue::Type::Int:
+                glProgramUniform1i(program, uniform.location, uniform.i);
+                break;
+            case UniformValue::Type::Float:
+                glProgramUniform1fv(program, uniform.location, 1, uniform.f);
+                break;
+            case UniformValue::Type::Vec2:
+                glProgramUniform2fv(program, uniform.location, 1, uniform.f);
+                break;
+            case UniformValue::Type::Vec3:
+                glProgramUniform3fv(program, uniform.location, 1, uniform.f);
+                break;
+            case UniformValue::Type::Vec4:
+                glProgramUniform4fv(program, uniform.location, 1, uniform.f);
+                break;
+            default:
+                throw std::invalid_argument("Invalid uniform type");
+            }
+        }
+    } // namespace
+
+    CommandList::CommandList(const std::size_t arena_block_size) : m_Arena(arena_block_size) {}
+
+    void CommandList::submit(const std::uint64_t key, const DrawDescription &draw) {
+        if (draw.textures.size() > 0xFF || draw.uniforms.size() > 0xFFFF) {
+            throw std::invalid_argument("Too many textures or uniforms for a single draw command");
+        }
+        if (!draw.pipeline->is_compatible(*draw.vertex_array)) {
+            throw std::invalid_argument("Vertex array layout doesn't match the pipeline's vertex layout");
+        }
+
+        const auto textures = m_Arena.copy<const Texture *>(draw.textures);
+        const auto uniforms = m_Arena.copy<UniformValue>(draw.uniforms);
+
+        const auto *command = m_Arena.create<DrawCommand>(DrawCommand {
+            .pipeline       = draw.pipeline,
+            .vertex_array   = draw.vertex_array,
+            .framebuffer    = draw.framebuffer,
+            .textures       = textures.data(),
+            .uniforms       = uniforms.data(),
+            .texture_count  = static_cast<std::uint8_t>(textures.size()),
+            .uniform_count  = static_cast<std::uint16_t>(uniforms.size()),
+            .primitive      = draw.primitive,
+            .first          = draw.first,
+            .count          = draw.count,
+            .instance_count = draw.instance_count,
+            .indexed        = draw.indexed,
+        });
+
+        m_Items.push_back({key, command});
+    }
+
+    void CommandList::submit(const std::uint8_t pass, const float depth, const DrawDescription &draw) {
+        const unsigned int texture = draw.textures.empty() || draw.textures[0] == nullptr ? 0 : draw.textures[0]->get_handle();
+        submit(sort_key::make(pass, draw.pipeline->get_id(), texture, draw.vertex_array->get_handle(), depth), draw);
+    }
+
+    void CommandList::reset() {
+        m_Items.clear();
+        m_Arena.reset();
+    }
+
+    RenderQueue::RenderQueue(const std::size_t arena_block_size) : m_ArenaBlockSize(arena_block_size), m_Primary(arena_block_size) {}
+
+    void RenderQueue::submit(const std::uint64_t key, const DrawDescription &draw) {
+        m_Primary.submit(key, draw);
+    }
+
+    void RenderQueue::submit(const std::uint8_t pass, const float depth, const DrawDescription &draw) {
+        m_Primary.submit(pass, depth, draw);
+    }
+
+    void RenderQueue::record_parallel(ThreadPool                                            &pool,
+                                      const std::size_t                                      partitions,
+                                      const std::function<void(std::size_t, CommandList &)> &record) {
+        const std::size_t first = m_ListsInUse;
+        while (m_Lists.size() < first + partitions) {
+            m_Lists.push_back(std::make_unique<CommandList>(m_ArenaBlockSize));
+        }
+        m_ListsInUse = first + partitions;
+
+        pool.parallel_for(partitions, [&](const std::size_t partition) { record(partition, *m_Lists[first + partition]); });
+    }
+
+    void RenderQueue::sort() {
+        // LSD radix sort over bytes, which is stable and so keeps submission order for equal keys. Bytes which are the same in every key are
+        // skipped, which for typical frames (few passes, few programs) removes most of the passes.
+        m_SortScratch.resize(m_Items.size());
+
+        for (unsigned int shift = 0; shift < 64; shift += 8) {
+            std::array<std::size_t, 256> counts {};
+            for (const auto &item : m_Items) {
+                counts[(item.key >> shift) & 0xFF]++;
+            }
+
+            if (counts[(m_Items.front().key >> shift) & 0xFF] == m_Items.size()) {
+                continue;
+            }
+
+            std::size_t offset = 0;
+            for (auto &count : counts) {
+                const std::size_t c = count;
+                count               = offset;
+                offset += c;
+            }
+
+            for (const auto &item : m_Items) {
+                m_SortScratch[counts[(item.key >> shift) & 0xFF]++] = item;
+            }
+
+            std::swap(m_Items, m_SortScratch);
+        }
+    }
+
+    void RenderQueue::execute() {
+        m_Items.clear();
+        m_Items.insert(m_Items.end(), m_Primary.get_items().begin(), m_Primary.get_items().end());
+        for (std::size_t i = 0; i < m_ListsInUse; i++) {
+            m_Items.insert(m_Items.end(), m_Lists[i]->get_items().begin(), m_Lists[i]->get_items().end());
+        }
+
+        if (m_Items.empty()) {
+            return;
+        }
+
+        sort();
+
+        for (const auto &item : m_Items) {
+            execute(*item.command);
+        }
+    }
+
+    void RenderQueue::execute(const DrawCommand &command) {
+        if (command.framebuffer != nullptr) {
+            command.framebuffer->bind();
+        } else {
+            Framebuffer::bind_default();
+        }
+
+        command.pipeline->bind();
+        for (std::uint16_t i = 0; i < command.uniform_count; i++) {
+            apply_uniform(command.pipeline->get_program().get_handle(), command.uniforms[i]);
+        }
+
+        m_Bindings.clear();
+        for (std::uint8_t i = 0; i < command.texture_count; i++) {
+            m_Bindings.set_texture(i, command.textures[i]);
+        }
+        m_Bindings.apply();
+
+        command.vertex_array->bind();
+
+        const auto mode = static_cast<GLenum>(command.primitive);
+        if (command.indexed) {
+            const auto *offset = reinterpret_cast<const void *>(static_cast<std::uintptr_t>(command.first) * sizeof(GLuint));
+            glDrawElementsInstanced(mode, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT, offset, static_cast<GLsizei>(command.instance_count));
+        } else {
+            glDrawArraysInstanced(
+                mode, static_cast<GLint>(command.first), static_cast<GLsizei>(command.count), static_cast<GLsizei>(command.instance_count));
+        }
+
+        BarrierTracker::get().commit_writes();
+    }
+
+    void RenderQueue::reset() {
+        m_Primary.reset();
+        for (std::size_t i = 0; i < m_ListsInUse; i++) {
+            m_Lists[i]->reset();
+        }
+        m_ListsInUse = 0;
+        m_Items.clear();
+    }
+
+    RenderQueue::Statistics RenderQueue::get_statistics() const noexcept {
+        Statistics statistics {m_Primary.get_items().size(), m_ListsInUse + 1, m_Primary.get_arena_bytes()};
+        for (std::size_t i = 0; i < m_ListsInUse; i++) {
+            statistics.commands += m_Lists[i]->get_items().size();
+            statistics.arena_bytes += m_Lists[i]->get_arena_bytes();
+        }
+        return statistics;
+    }
+} // namespace game::render
@@ -0,0 +1,169 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/arena.hpp"
+#include "game/thread_pool.hpp"
+#include "game/render/binding_set.hpp"
+#include "game/render/pipeline.hpp"
+#include "game/render/render.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace game::render {
+    enum class PrimitiveType : GLenum {
+        Points        = GL_POINTS,
+        Lines         = GL_LINES,
+        LineStrip     = GL_LINE_STRIP,
+        Triangles     = GL_TRIANGLES,
+        TriangleStrip = GL_TRIANGLE_STRIP,
+        TriangleFan   = GL_TRIANGLE_FAN,
+    };
+
+    // A uniform value baked into a command, addressed by location so executing it needs no name lookups.
+    struct UniformValue {
+        enum class Type : std::uint8_t {
+            Int,
+            Float,
+            Vec2,
+            Vec3,
+            Vec4,
+        };
+
+        int   location;
+        Type  type;
+        union {
+            int   i;
+            float f[4];
+        };
+
+        static UniformValue of(int location, int value);
+        static UniformValue of(int location, float value);
+        static UniformValue of(int location, const glm::vec2 &value);
+        static UniformValue of(int location, const glm::vec3 &value);
+        static UniformValue of(int location, const glm::vec4 &value);
+    };
+
+    // What a caller submits. Spans only need to stay valid for the duration of RenderQueue::submit.
+    struct DrawDescription {
+        const Pipeline    *pipeline;
+        const VertexArray *vertex_array; // must match the pipeline's vertex layout
+        const Framebuffer *framebuffer = nullptr; // nullptr is the default framebuffer
+
+        // bound to consecutive units starting at 0, each with its own sampler
+        std::span<const Texture *const> textures = {};
+        std::span<const UniformValue>   uniforms = {};
+
+        PrimitiveType primitive      = PrimitiveType::Triangles;
+        unsigned int  first          = 0;
+        unsigned int  count          = 0;
+        unsigned int  instance_count = 1;
+        bool          indexed        = false; // 32-bit indices from the vertex array's element buffer, `first` counts indices
+    };
+
+    // The recorded form of a draw. Plain data living in the queue's arena until the queue is reset.
+    struct DrawCommand {
+        const Pipeline       *pipeline;
+        const VertexArray    *vertex_array;
+        const Framebuffer    *framebuffer;
+        const Texture *const *textures;
+        const UniformValue   *uniforms;
+        std::uint8_t          texture_count;
+        std::uint16_t         uniform_count;
+        PrimitiveType         primitive;
+        unsigned int          first;
+        unsigned int          count;
+        unsigned int          instance_count;
+        bool                  indexed;
+    };
+
+    // 64-bit sort keys, most significant first: pass (8 bits), pipeline id (12), first texture (12), vertex array (12), depth (20). Ids and object
+    // names are truncated to 12 bits; a collision only costs a redundant state change, never correctness.
+    namespace sort_key {
+        constexpr unsigned int pass_bits     = 8;
+        constexpr unsigned int pipeline_bits = 12;
+        constexpr unsigned int texture_bits = 12;
+        constexpr unsigned int vao_bits     = 12;
+        constexpr unsigned int depth_bits   = 20;
+
+        // depth is expected in [0, 1], smaller depths sort first
+        std::uint64_t make(std::uint8_t pass, unsigned int pipeline, unsigned int texture, unsigned int vertex_array, float depth);
+    } // namespace sort_key
+
+    // A sequence of recorded draw commands. Recording makes no GL calls and only reads immutable properties (object names) of the wrappers
+    // referenced, so each list can be filled on its own worker thread while the GL thread is busy with something else.
+    class CommandList {
+      public:
+        struct Item {
+            std::uint64_t      key;
+            const DrawCommand *command;
+        };
+
+        explicit CommandList(std::size_t arena_block_size = 64 * 1024);
+
+        void submit(std::uint64_t key, const DrawDescription &draw);
+        // builds the key from the draw's own state
+        void submit(std::uint8_t pass, float depth, const DrawDescription &draw);
+
+        // Drops all recorded commands, keeping the memory for the next frame.
+        void reset();
+
+        [[nodiscard]] std::span<const Item> get_items() const noexcept { return m_Items; }
+
+        [[nodiscard]] std::size_t get_arena_bytes() const noexcept { return m_Arena.get_bytes_used(); }
+
+      private:
+        LinearArena       m_Arena;
+        std::vector<Item> m_Items;
+    };
+
+    // Collects command lists (its own primary list plus any recorded in parallel) and executes all their commands sorted by key, so that draws
+    // sharing state end up next to each other. Commands with equal keys execute in submission order: the primary list first, then the
+    // parallel lists in partition order, regardless of which worker finished first.
+    class RenderQueue {
+      public:
+        struct Statistics {
+            std::size_t commands;
+            std::size_t command_lists;
+            std::size_t arena_bytes;
+        };
+
+        explicit RenderQueue(std::size_t arena_block_size = 64 * 1024);
+
+        void submit(std::uint64_t key, const DrawDescription &draw);
+        void submit(std::uint8_t pass, float depth, const DrawDescription &draw);
+
+        // Calls record(partition, list) for every partition on the pool, each with a list of its own, and adds the lists to the queue once all
+        // of them are done.
+        void record_parallel(ThreadPool &pool, std::size_t partitions, const std::function<void(std::size_t, CommandList &)> &record);
+
+        // Must run on the thread owning the GL context.
+        void execute();
+
+        // Drops all recorded commands of all lists, keeping their memory for the next frame.
+        void reset();
+
+        [[nodiscard]] Statistics get_statistics() const noexcept;
+
+      private:
+        void sort();
+        void execute(const DrawCommand &command);
+
+        std::size_t m_ArenaBlockSize;
+
+        CommandList                               m_Primary;
+        std::vector<std::unique_ptr<CommandList>> m_Lists;
+        std::size_t                               m_ListsInUse = 0;
+
+        std::vector<CommandList::Item> m_Items;
+        std::vector<CommandList::Item> m_SortScratch;
+
+        TextureBindingSet m_Bindings;
+    };
+} // namespace game::render
@@ -4,42 +4,206 @@
 
 #include "game/render/render_target.hpp"
 
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
 namespace game::render {
-    RenderTarget::RenderTarget(const Description &description) {}
+    namespace {
+        bool is_color(const Framebuffer::Attachment attachment_point) {
+            const auto point = static_cast<GLenum>(attachment_point);
+            return point >= GL_COLOR_ATTACHMENT0 && point <= GL_COLOR_ATTACHMENT31;
+        }
 
-    RenderTarget::RenderTarget(unsigned int width, unsigned int height) {
-        auto texture = std::make_unique<Texture>(Texture::Type::Texture2D);
-        texture->set_image_2d(width, height, Format::RGBA8);
+        bool has_depth(const RenderTarget::Description &description) {
+            return std::ranges::any_of(description.attachments, [](const RenderTarget::Attachment &attachment) {
+                return attachment.attachment_point == Framebuffer::Attachment::Depth ||
+                       attachment.attachment_point == Framebuffer::Attachment::DepthStencil;
+            });
+        }
 
-        auto rb = std::make_unique<RenderBuffer>(width, height, Format::D24S8);
+        bool has_stencil(const RenderTarget::Description &description) {
+            return std::ranges::any_of(description.attachments, [](const RenderTarget::Attachment &attachment) {
+                return attachment.attachment_point == Framebuffer::Attachment::Stencil ||
+                       attachment.attachment_point == Framebuffer::Attachment::DepthStencil;
+            });
+        }
+    } // namespace
+
+    RenderTarget::Description RenderTarget::Description::resolved() const {
+        Description description {width, height, {}, 1};
+        for (const auto &attachment : attachments) {
+            if (is_color(attachment.attachment_point)) {
+                description.attachments.push_back({attachment.attachment_point, attachment.format});
+            }
+        }
+        return description;
+    }
 
+    RenderTarget::RenderTarget(const Description &description)
+        : m_Description(description), m_Samples(std::clamp(description.samples, 1u, get_max_samples())) {
         m_Framebuffer = std::make_unique<Framebuffer>();
-        m_Framebuffer->attachment(texture.get(), Framebuffer::Attachment::Color0);
-        m_Framebuffer->attachment(rb.get(), Framebuffer::Attachment::DepthStencil);
 
-        m_Textures.insert(std::make_pair(Framebuffer::Attachment::Color0, std::move(texture)));
-        m_RenderBuffers.insert(std::make_pair(Framebuffer::Attachment::DepthStencil, std::move(rb)));
+        for (const auto &[attachment_point, format, renderbuffer] : description.attachments) {
+            if (renderbuffer) {
+                auto buffer = m_Samples > 1 ? std::make_unique<RenderBuffer>(description.width, description.height, format, m_Samples)
+                                            : std::make_unique<RenderBuffer>(description.width, description.height, format);
+                m_Framebuffer->attachment(buffer.get(), attachment_point);
+                m_RenderBuffers.insert_or_assign(attachment_point, std::move(buffer));
+            } else if (m_Samples > 1) {
+                auto texture = std::make_unique<Texture>(Texture::Type::Texture2DMS);
+                texture->set_storage_2d_multisample(description.width, description.height, format, m_Samples);
+                m_Framebuffer->attachment(texture.get(), attachment_point);
+                m_Textures.insert_or_assign(attachment_point, std::move(texture));
+            } else {
+                auto texture = std::make_unique<Texture>(Texture::Type::Texture2D);
+                texture->set_storage_2d(description.width, description.height, format);
+                m_Framebuffer->attachment(texture.get(), attachment_point);
+                m_Textures.insert_or_assign(attachment_point, std::move(texture));
+            }
+            m_MemorySize += image_size(format, description.width, description.height) * m_Samples;
+
+            if (is_color(attachment_point)) {
+                m_DrawBuffers.push_back(static_cast<GLenum>(attachment_point));
+            }
+        }
+
+        // fragment outputs go to the color attachments in order of their attachment points
+        std::ranges::sort(m_DrawBuffers);
+        set_draw_buffers();
+
+        if (!m_Framebuffer->is_complete()) {
+            throw std::runtime_error("Render target attachments don't form a complete framebuffer");
+        }
     }
 
-    const std::unique_ptr<Texture> &RenderTarget::get_texture(const Framebuffer::Attachment attachment_point) {
-        const auto it = m_Textures.find(attachment_point);
-        if (it == m_Textures.end()) {
-            return nullptr;
+    RenderTarget::RenderTarget(const unsigned int width, const unsigned int height) : RenderTarget(color_depth_description(width, height)) {}
+
+    RenderTarget::Description
+    RenderTarget::color_depth_description(const unsigned int width, const unsigned int height, const unsigned int samples) {
+        return {width,
+                height,
+                {{Framebuffer::Attachment::Color0, Format::RGBA8}, {Framebuffer::Attachment::DepthStencil, Format::D24S8, true}},
+                samples};
+    }
+
+    unsigned int RenderTarget::get_max_samples() {
+        thread_local std::optional<unsigned int> max_samples;
+        if (!max_samples.has_value()) {
+            GLint value = 1;
+            glGetIntegerv(GL_MAX_SAMPLES, &value);
+            max_samples = static_cast<unsigned int>(std::max(value, 1));
         }
+        return *max_samples;
+    }
+
+    void RenderTarget::resolve(const RenderTarget &destination, const bool depth_stencil) const {
+        if (destination.m_Description.width != m_Description.width || destination.m_Description.height != m_Description.height) {
+            throw std::invalid_argument("Render targets resolved into each other must be the same size");
+        }
+
+        const unsigned int source = m_Framebuffer->get_handle();
+        const unsigned int target = destination.m_Framebuffer->get_handle();
 
-        return it->second;
+        // a blit reads one color buffer and writes all draw buffers, so attachments go one at a time
+        for (const GLenum point : m_DrawBuffers) {
+            if (std::ranges::find(destination.m_DrawBuffers, point) == destination.m_DrawBuffers.end()) {
+                continue;
+            }
+            glNamedFramebufferReadBuffer(source, point);
+            glNamedFramebufferDrawBuffer(target, point);
+            m_Framebuffer->blit(*destination.m_Framebuffer, m_Description.width, m_Description.height, GL_COLOR_BUFFER_BIT);
+        }
+        set_draw_buffers();
+        destination.set_draw_buffers();
+
+        GLbitfield mask = 0;
+        if (depth_stencil && has_depth(m_Description) && has_depth(destination.m_Description)) {
+            mask |= GL_DEPTH_BUFFER_BIT;
+        }
+        if (depth_stencil && has_stencil(m_Description) && has_stencil(destination.m_Description)) {
+            mask |= GL_STENCIL_BUFFER_BIT;
+        }
+        if (mask != 0) {
+            m_Framebuffer->blit(*destination.m_Framebuffer, m_Description.width, m_Description.height, mask);
+        }
     }
 
-    const std::unique_ptr<RenderBuffer> &RenderTarget::get_renderbuffer(const Framebuffer::Attachment attachment_point) {
-        const auto it = m_RenderBuffers.find(attachment_point);
-        if (it == m_RenderBuffers.end()) {
-            return nullptr;
+    void RenderTarget::set_draw_buffers() const {
+        const unsigned int framebuffer = m_Framebuffer->get_handle();
+        if (m_DrawBuffers.empty()) {
+            glNamedFramebufferDrawBuffer(framebuffer, GL_NONE);
+            glNamedFramebufferReadBuffer(framebuffer, GL_NONE);
+        } else {
+            glNamedFramebufferDrawBuffers(framebuffer, static_cast<GLsizei>(m_DrawBuffers.size()), m_DrawBuffers.data());
+            glNamedFramebufferReadBuffer(framebuffer, m_DrawBuffers.front());
         }
+    }
 
-        return it->second;
+    Texture *RenderTarget::get_texture(const Framebuffer::Attachment attachment_point) const {
+        const auto it = m_Textures.find(attachment_point);
+        return it != m_Textures.end() ? it->second.get() : nullptr;
+    }
+
+    RenderBuffer *RenderTarget::get_renderbuffer(const Framebuffer::Attachment attachment_point) const {
+        const auto it = m_RenderBuffers.find(attachment_point);
+        return it != m_RenderBuffers.end() ? it->second.get() : nullptr;
     }
 
     void RenderTarget::bind() const {
         m_Framebuffer->bind();
     }
+
+    void RenderTarget::begin_pass(const RenderPassActions &actions) const {
+        m_Framebuffer->begin_pass(actions);
+    }
+
+    void RenderTarget::end_pass(const RenderPassActions &actions) const {
+        m_Framebuffer->end_pass(actions);
+    }
+
+    RenderTargetPool::RenderTargetPool(const unsigned int max_idle_frames) : m_MaxIdleFrames(max_idle_frames) {}
+
+    RenderTarget *RenderTargetPool::acquire(const RenderTarget::Description &description) {
+        for (auto &entry : m_Entries) {
+            if (!entry.in_use && entry.target->get_description() == description) {
+                entry.in_use    = true;
+                entry.last_used = m_Frame;
+                m_Hits++;
+                return entry.target.get();
+            }
+        }
+
+        m_Misses++;
+        m_Entries.push_back({std::make_unique<RenderTarget>(description), true, m_Frame});
+        return m_Entries.back().target.get();
+    }
+
+    void RenderTargetPool::release(const RenderTarget *target) {
+        const auto it = std::ranges::find_if(m_Entries, [&](const Entry &entry) { return entry.target.get() == target; });
+        if (it != m_Entries.end()) {
+            it->in_use = false;
+        }
+    }
+
+    void RenderTargetPool::end_frame() {
+        for (auto &entry : m_Entries) {
+            entry.in_use = false;
+        }
+        std::erase_if(m_Entries, [&](const Entry &entry) { return m_Frame - entry.last_used >= m_MaxIdleFrames; });
+        m_Frame++;
+    }
+
+    void RenderTargetPool::trim() {
+        std::erase_if(m_Entries, [](const Entry &entry) { return !entry.in_use; });
+    }
+
+    RenderTargetPool::Statistics RenderTargetPool::get_statistics() const noexcept {
+        Statistics statistics {m_Hits, m_Misses, m_Entries.size(), 0, 0};
+        for (const auto &entry : m_Entries) {
+            statistics.targets_in_use += entry.in_use ? 1 : 0;
+            statistics.memory_size += entry.target->get_memory_size();
+        }
+        return statistics;
+    }
 } // namespace game::render
@@ -6,33 +6,124 @@
 
 #include "game/render/render.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 namespace game::render {
 
     class RenderTarget {
-    public:
+      public:
         struct Attachment {
             Framebuffer::Attachment attachment_point;
-            Format format;
+            Format                  format;
+            // renderbuffers can't be sampled, which is fine for depth buffers only rendered against
             bool renderbuffer = false;
+
+            bool operator==(const Attachment &other) const = default;
         };
 
         struct Description {
-            unsigned int width, height;
+            unsigned int            width, height;
             std::vector<Attachment> attachments;
+            // above 1 textures are multisample textures and renderbuffers multisample renderbuffers, which have to be resolved into a
+            // single-sample target before anything can sample them
+            unsigned int samples = 1;
+
+            bool operator==(const Description &other) const = default;
+
+            // what a multisampled target resolves into: its color attachments as single-sample textures
+            [[nodiscard]] Description resolved() const;
         };
 
-        explicit RenderTarget(const Description& description);
+        // Creates a framebuffer with a single-level texture or renderbuffer for every attachment. Throws if the combination isn't complete.
+        // Sample counts above what the implementation supports are clamped.
+        explicit RenderTarget(const Description &description);
+        // RGBA8 color texture and a D24S8 depth/stencil renderbuffer
         RenderTarget(unsigned int width, unsigned int height);
 
-        const std::unique_ptr<Texture>& get_texture(Framebuffer::Attachment attachment_point);
-        const std::unique_ptr<RenderBuffer>& get_renderbuffer(Framebuffer::Attachment attachment_point);
+        RenderTarget(const RenderTarget &)            = delete;
+        RenderTarget &operator=(const RenderTarget &) = delete;
+
+        [[nodiscard]] static Description color_depth_description(unsigned int width, unsigned int height, unsigned int samples = 1);
+
+        // GL_MAX_SAMPLES
+        [[nodiscard]] static unsigned int get_max_samples();
+
+        // nullptr if the attachment point has no texture (or no renderbuffer respectively)
+        [[nodiscard]] Texture      *get_texture(Framebuffer::Attachment attachment_point) const;
+        [[nodiscard]] RenderBuffer *get_renderbuffer(Framebuffer::Attachment attachment_point) const;
+
+        [[nodiscard]] const Description &get_description() const noexcept { return m_Description; }
+        [[nodiscard]] Framebuffer       *get_framebuffer() const noexcept { return m_Framebuffer.get(); }
+        [[nodiscard]] std::size_t        get_memory_size() const noexcept { return m_MemorySize; }
+        // the sample count actually allocated
+        [[nodiscard]] unsigned int get_samples() const noexcept { return m_Samples; }
+
+        // Resolves (or copies, from a single-sample target) every color attachment into the same attachment point of `destination`, and with
+        // `depth_stencil` the depth and stencil buffers both have as well. Both targets must be the same size.
+        void resolve(const RenderTarget &destination, bool depth_stencil = false) const;
 
         void bind() const;
-    private:
-        std::unique_ptr<Framebuffer> m_Framebuffer;
-        std::unordered_map<Framebuffer::Attachment, std::unique_ptr<Texture>> m_Textures;
+
+        void begin_pass(const RenderPassActions &actions) const;
+        void end_pass(const RenderPassActions &actions) const;
+
+      private:
+        void set_draw_buffers() const;
+
+        Description                                                                m_Description;
+        unsigned int                                                               m_Samples;
+        std::vector<GLenum>                                                        m_DrawBuffers;
+        std::unique_ptr<Framebuffer>                                               m_Framebuffer;
+        std::unordered_map<Framebuffer::Attachment, std::unique_ptr<Texture>>      m_Textures;
         std::unordered_map<Framebuffer::Attachment, std::unique_ptr<RenderBuffer>> m_RenderBuffers;
+        std::size_t                                                                m_MemorySize = 0;
+    };
+
+    // Hands out render targets matching a description for the rest of the frame, recycling them once the frame ends, so targets needed
+    // every frame are only created once and stages that don't run at the same time can share one. Targets not used for `max_idle_frames`
+    // frames are deleted.
+    class RenderTargetPool {
+      public:
+        struct Statistics {
+            std::size_t hits;   // acquisitions served by an existing target
+            std::size_t misses; // acquisitions that created a target
+            std::size_t targets;
+            std::size_t targets_in_use;
+            std::size_t memory_size; // of every pooled target, in use or not
+        };
+
+        explicit RenderTargetPool(unsigned int max_idle_frames = 3);
+
+        RenderTargetPool(const RenderTargetPool &)            = delete;
+        RenderTargetPool &operator=(const RenderTargetPool &) = delete;
+
+        // The target's contents are undefined, begin its pass with Clear or DontCare unless everything is overwritten anyway.
+        RenderTarget *acquire(const RenderTarget::Description &description);
+        // Returns a target before the frame ends, for later acquisitions in the same frame to reuse. Targets the pool doesn't own are ignored.
+        void release(const RenderTarget *target);
+
+        // Returns every target to the pool and deletes the ones that have been idle for too long.
+        void end_frame();
+        // Deletes every target which is not currently acquired.
+        void trim();
+
+        [[nodiscard]] Statistics get_statistics() const noexcept;
+
+      private:
+        struct Entry {
+            std::unique_ptr<RenderTarget> target;
+            bool                          in_use;
+            std::uint64_t                 last_used; // frame
+        };
 
+        unsigned int       m_MaxIdleFrames;
+        std::vector<Entry> m_Entries;
+        std::uint64_t      m_Frame  = 0;
+        std::size_t        m_Hits   = 0;
+        std::size_t        m_Misses = 0;
     };
 
 } // namespace game::render
@@ -0,0 +1,174 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/resource_cache.hpp"
+
+#include "game/asset_pack.hpp"
+#include "game/hash.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <ranges>
+#include <stdexcept>
+
+namespace game::render {
+    namespace {
+        std::vector<std::uint8_t> read_file(const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+            if (!file) {
+                throw std::runtime_error(std::format("Failed to open {}", path.string()));
+            }
+            std::vector<std::uint8_t> bytes(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0, std::ios::beg);
+            file.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            return bytes;
+        }
+
+        std::span<const std::uint8_t> as_bytes(const std::string_view text) {
+            return {reinterpret_cast<const std::uint8_t *>(text.data()), text.size()};
+        }
+
+        template <typename Map, typename Key> auto find(Map &map, const Key &key) {
+            const auto it = map.entries.find(key);
+            if (it == map.entries.end()) {
+                return decltype(it->second.lock())();
+            }
+            auto object = it->second.lock();
+            if (object == nullptr) {
+                map.entries.erase(it);
+            }
+            return object;
+        }
+
+        // Entries of objects that went away are otherwise only dropped when looked up again. Sweeping once the map has doubled since the
+        // last sweep keeps the cost constant per insertion.
+        template <typename Map, typename Key, typename T> void insert(Map &map, const Key &key, const std::shared_ptr<T> &object) {
+            map.entries.insert_or_assign(key, object);
+            if (map.entries.size() >= map.sweep_at) {
+                std::erase_if(map.entries, [](const auto &entry) { return entry.second.expired(); });
+                map.sweep_at = std::max(map.sweep_at, map.entries.size() * 2);
+            }
+        }
+
+        std::string path_key(const std::filesystem::path &path) {
+            return path.lexically_normal().generic_string();
+        }
+    } // namespace
+
+    ResourceCache &ResourceCache::get() {
+        thread_local ResourceCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<Texture> ResourceCache::load_texture(const std::filesystem::path &path, const bool mipmaps) {
+        // the same file loaded with and without mipmaps is two different textures
+        const std::string key = path_key(path) + (mipmaps ? "" : "|no-mips");
+        if (auto texture = find(m_Textures.by_path, key)) {
+            m_PathHits++;
+            return texture;
+        }
+
+        const std::vector<std::uint8_t> file = read_file(path);
+        std::uint64_t                   hash = hash_bytes(file);
+        hash_combine(hash, mipmaps);
+
+        auto texture = find(m_Textures.by_content, hash);
+        if (texture != nullptr) {
+            m_ContentHits++;
+        } else {
+            texture = Texture::load_from_memory(file, mipmaps);
+            m_Misses++;
+            insert(m_Textures.by_content, hash, texture);
+        }
+        insert(m_Textures.by_path, key, texture);
+        return texture;
+    }
+
+    std::shared_ptr<Texture> ResourceCache::load_texture(const AssetPack &pack, const std::string_view path, const bool mipmaps) {
+        // hashing straight from the mapping is cheap next to decoding, and unlike the path can't mix up assets of different packs
+        const auto    file = pack.get(path);
+        std::uint64_t hash = hash_bytes(file);
+        hash_combine(hash, mipmaps);
+
+        if (auto texture = find(m_Textures.by_content, hash)) {
+            m_ContentHits++;
+            return texture;
+        }
+
+        auto texture = Texture::load_from_memory(file, mipmaps);
+        m_Misses++;
+        insert(m_Textures.by_content, hash, texture);
+        return texture;
+    }
+
+    std::shared_ptr<ShaderProgram> ResourceCache::load_program(const ProgramPaths &paths) {
+        std::string key;
+        for (const auto &[type, path] : paths) {
+            key += std::format("{}:{}\n", static_cast<GLenum>(type), path_key(path));
+        }
+        if (auto program = find(m_Programs.by_path, key)) {
+            m_PathHits++;
+            return program;
+        }
+
+        std::vector<std::string> texts;
+        texts.reserve(paths.size());
+        for (const auto &path : paths | std::views::values) {
+            const std::vector<std::uint8_t> file = read_file(path);
+            texts.emplace_back(file.begin(), file.end());
+        }
+
+        std::vector<std::pair<ShaderModule::Type, std::string_view>> sources;
+        sources.reserve(paths.size());
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            sources.emplace_back(paths[i].first, texts[i]);
+        }
+
+        auto program = find_or_create_program(sources);
+        insert(m_Programs.by_path, key, program);
+        return program;
+    }
+
+    std::shared_ptr<ShaderProgram> ResourceCache::load_program(const AssetPack &pack, const PackProgramPaths &paths) {
+        std::vector<std::pair<ShaderModule::Type, std::string_view>> sources;
+        sources.reserve(paths.size());
+        for (const auto &[type, path] : paths) {
+            sources.emplace_back(type, pack.get_text(path));
+        }
+        return find_or_create_program(sources);
+    }
+
+    std::shared_ptr<ShaderProgram>
+    ResourceCache::find_or_create_program(const std::vector<std::pair<ShaderModule::Type, std::string_view>> &sources) {
+        std::uint64_t hash = 0;
+        for (const auto &[type, source] : sources) {
+            hash_combine(hash, static_cast<GLenum>(type));
+            hash_combine(hash, hash_bytes(as_bytes(source)));
+        }
+
+        if (auto program = find(m_Programs.by_content, hash)) {
+            m_ContentHits++;
+            return program;
+        }
+
+        auto program = ShaderProgram::create(sources);
+        m_Misses++;
+        insert(m_Programs.by_content, hash, program);
+        return program;
+    }
+
+    void ResourceCache::clear() {
+        m_Textures = {};
+        m_Programs = {};
+    }
+
+    ResourceCache::Statistics ResourceCache::get_statistics() const noexcept {
+        // every live object has exactly one content entry
+        const auto alive = [](const auto &map) {
+            return static_cast<std::size_t>(std::ranges::count_if(map, [](const auto &entry) { return !entry.second.expired(); }));
+        };
+        return {m_PathHits, m_ContentHits, m_Misses, alive(m_Textures.by_content.entries), alive(m_Programs.by_content.entries)};
+    }
+} // namespace game::render
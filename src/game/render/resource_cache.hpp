@@ -0,0 +1,76 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/render/render.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace game::render {
+    // Hands out shared textures and shader programs, so everything using the same asset shares one GL object instead of each load creating
+    // its own. Loose files are looked up by path first, which skips reading them again; failing that (and always for pack assets, whose
+    // paths don't say which pack they came from) by a hash of their contents, which also shares identical assets stored under different
+    // names. Only weak references are kept: an object goes away with its last user, and is read again the next time it's asked for.
+    //
+    // Files changed on disk are only picked up once nothing uses their object anymore, or after clear().
+    class ResourceCache {
+      public:
+        struct Statistics {
+            std::size_t path_hits;    // found without reading anything
+            std::size_t content_hits; // read and hashed, but not decoded or compiled again
+            std::size_t misses;
+            std::size_t textures; // alive
+            std::size_t programs;
+        };
+
+        using ProgramPaths     = std::vector<std::pair<ShaderModule::Type, std::filesystem::path>>;
+        using PackProgramPaths = std::vector<std::pair<ShaderModule::Type, std::string_view>>;
+
+        static ResourceCache &get();
+
+        // Same as Texture::load, except for sharing.
+        std::shared_ptr<Texture> load_texture(const std::filesystem::path &path, bool mipmaps = true);
+        std::shared_ptr<Texture> load_texture(const AssetPack &pack, std::string_view path, bool mipmaps = true);
+
+        // Same as ShaderProgram::load, except for sharing.
+        std::shared_ptr<ShaderProgram> load_program(const ProgramPaths &paths);
+        std::shared_ptr<ShaderProgram> load_program(const AssetPack &pack, const PackProgramPaths &paths);
+
+        // Forgets every object, so the next load of anything reads it again. Objects still in use stay alive with their users.
+        void clear();
+
+        [[nodiscard]] Statistics get_statistics() const noexcept;
+
+      private:
+        ResourceCache() = default;
+
+        template <typename Key, typename T> struct WeakMap {
+            std::unordered_map<Key, std::weak_ptr<T>> entries;
+            std::size_t                               sweep_at = 64; // size at which entries of expired objects are swept out next
+        };
+
+        template <typename T> struct Table {
+            WeakMap<std::string, T>   by_path;
+            WeakMap<std::uint64_t, T> by_content;
+        };
+
+        // the content hash of a program covers its stages and their sources
+        std::shared_ptr<ShaderProgram> find_or_create_program(const std::vector<std::pair<ShaderModule::Type, std::string_view>> &sources);
+
+        Table<Texture>       m_Textures;
+        Table<ShaderProgram> m_Programs;
+
+        std::size_t m_PathHits    = 0;
+        std::size_t m_ContentHits = 0;
+        std::size_t m_Misses      = 0;
+    };
+} // namespace game::render
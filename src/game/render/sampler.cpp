@@ -0,0 +1,130 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/sampler.hpp"
+#include "game/hash.hpp"
+
+#include <algorithm>
+
+namespace game::render {
+    namespace {
+        GLenum min_filter_mode(const Filter filter, const MipmapMode mipmap_mode) {
+            switch (mipmap_mode) {
+            case MipmapMode::Nearest:
+                return filter == Filter::Nearest ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_NEAREST;
+            case MipmapMode::Linear:
+                return filter == Filter::Nearest ? GL_NEAREST_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_LINEAR;
+            default:
+                return static_cast<GLenum>(filter);
+            }
+        }
+    } // namespace
+
+    std::size_t SamplerDescription::hash() const noexcept {
+        std::size_t seed = 0;
+        hash_combine(seed, static_cast<GLenum>(min_filter));
+        hash_combine(seed, static_cast<GLenum>(mag_filter));
+        hash_combine(seed, static_cast<int>(mipmap_mode));
+        hash_combine(seed, static_cast<GLenum>(wrap_s));
+        hash_combine(seed, static_cast<GLenum>(wrap_t));
+        hash_combine(seed, static_cast<GLenum>(wrap_r));
+        for (const float component : border_color) {
+            hash_combine(seed, component);
+        }
+        hash_combine(seed, max_anisotropy);
+        hash_combine(seed, lod_bias);
+        hash_combine(seed, min_lod);
+        hash_combine(seed, max_lod);
+        hash_combine(seed, compare.has_value() ? static_cast<GLenum>(*compare) : 0u);
+        return seed;
+    }
+
+    SamplerDescription SamplerDescription::nearest(const WrapMode wrap) {
+        return {.min_filter = Filter::Nearest, .mag_filter = Filter::Nearest, .wrap_s = wrap, .wrap_t = wrap, .wrap_r = wrap};
+    }
+
+    SamplerDescription SamplerDescription::linear(const WrapMode wrap) {
+        return {.min_filter = Filter::Linear, .mag_filter = Filter::Linear, .wrap_s = wrap, .wrap_t = wrap, .wrap_r = wrap};
+    }
+
+    SamplerDescription SamplerDescription::trilinear(const WrapMode wrap, const float max_anisotropy) {
+        return {.min_filter     = Filter::Linear,
+                .mag_filter     = Filter::Linear,
+                .mipmap_mode    = MipmapMode::Linear,
+                .wrap_s         = wrap,
+                .wrap_t         = wrap,
+                .wrap_r         = wrap,
+                .max_anisotropy = max_anisotropy};
+    }
+
+    Sampler::Sampler(const SamplerDescription &description) : m_Description(description) {
+        glCreateSamplers(1, &m_Sampler);
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(min_filter_mode(description.min_filter, description.mipmap_mode)));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(description.mag_filter));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_S, static_cast<GLint>(description.wrap_s));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_T, static_cast<GLint>(description.wrap_t));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_R, static_cast<GLint>(description.wrap_r));
+        glSamplerParameterfv(m_Sampler, GL_TEXTURE_BORDER_COLOR, description.border_color.data());
+        glSamplerParameterf(m_Sampler, GL_TEXTURE_LOD_BIAS, description.lod_bias);
+        glSamplerParameterf(m_Sampler, GL_TEXTURE_MIN_LOD, description.min_lod);
+        glSamplerParameterf(m_Sampler, GL_TEXTURE_MAX_LOD, description.max_lod);
+
+        if (description.max_anisotropy > 1.0f) {
+            glSamplerParameterf(
+                m_Sampler, GL_TEXTURE_MAX_ANISOTROPY, std::min(description.max_anisotropy, SamplerCache::get().get_max_anisotropy()));
+        }
+
+        if (description.compare.has_value()) {
+            glSamplerParameteri(m_Sampler, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            glSamplerParameteri(m_Sampler, GL_TEXTURE_COMPARE_FUNC, static_cast<GLint>(*description.compare));
+        }
+    }
+
+    Sampler::~Sampler() {
+        StateCache::get().on_sampler_deleted(m_Sampler);
+        glDeleteSamplers(1, &m_Sampler);
+    }
+
+    void Sampler::bind(const unsigned int unit) const {
+        StateCache::get().bind_sampler(unit, m_Sampler);
+    }
+
+    unsigned int Sampler::get_handle() const noexcept {
+        return m_Sampler;
+    }
+
+    const SamplerDescription &Sampler::get_description() const noexcept {
+        return m_Description;
+    }
+
+    SamplerCache &SamplerCache::get() {
+        thread_local SamplerCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const Sampler> SamplerCache::get_sampler(const SamplerDescription &description) {
+        const auto it = m_Samplers.find(description);
+        if (it != m_Samplers.end()) {
+            return it->second;
+        }
+
+        auto sampler = std::make_shared<const Sampler>(description);
+        m_Samplers.emplace(description, sampler);
+        return sampler;
+    }
+
+    float SamplerCache::get_max_anisotropy() {
+        if (!m_MaxAnisotropy.has_value()) {
+            float max_anisotropy;
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &max_anisotropy);
+            m_MaxAnisotropy = max_anisotropy;
+        }
+
+        return *m_MaxAnisotropy;
+    }
+
+    void SamplerCache::clear() {
+        m_Samplers.clear();
+    }
+} // namespace game::render
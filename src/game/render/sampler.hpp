@@ -0,0 +1,106 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/render/state_cache.hpp"
+
+#include <array>
+#include <glad/gl.h>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+namespace game::render {
+    enum class Filter : GLenum {
+        Nearest = GL_NEAREST,
+        Linear  = GL_LINEAR,
+    };
+
+    enum class MipmapMode {
+        None,
+        Nearest,
+        Linear,
+    };
+
+    enum class WrapMode : GLenum {
+        Repeat            = GL_REPEAT,
+        MirroredRepeat    = GL_MIRRORED_REPEAT,
+        ClampToEdge       = GL_CLAMP_TO_EDGE,
+        ClampToBorder     = GL_CLAMP_TO_BORDER,
+        MirrorClampToEdge = GL_MIRROR_CLAMP_TO_EDGE,
+    };
+
+    // Everything about how a texture is sampled. Descriptions are plain values; the GL sampler objects for them are shared through SamplerCache.
+    struct SamplerDescription {
+        Filter     min_filter  = Filter::Linear;
+        Filter     mag_filter  = Filter::Linear;
+        MipmapMode mipmap_mode = MipmapMode::None;
+
+        WrapMode wrap_s = WrapMode::ClampToEdge;
+        WrapMode wrap_t = WrapMode::ClampToEdge;
+        WrapMode wrap_r = WrapMode::ClampToEdge;
+
+        std::array<float, 4> border_color = {0.0f, 0.0f, 0.0f, 0.0f};
+
+        // clamped to what the implementation supports
+        float max_anisotropy = 1.0f;
+        float lod_bias       = 0.0f;
+        float min_lod        = -1000.0f;
+        float max_lod        = 1000.0f;
+
+        // enables depth comparison (for shadow samplers) when set
+        std::optional<CompareOp> compare;
+
+        bool operator==(const SamplerDescription &other) const = default;
+
+        [[nodiscard]] std::size_t hash() const noexcept;
+
+        static SamplerDescription nearest(WrapMode wrap = WrapMode::ClampToEdge);
+        static SamplerDescription linear(WrapMode wrap = WrapMode::ClampToEdge);
+        static SamplerDescription trilinear(WrapMode wrap = WrapMode::Repeat, float max_anisotropy = 1.0f);
+    };
+
+    class Sampler {
+      public:
+        explicit Sampler(const SamplerDescription &description);
+        ~Sampler();
+
+        Sampler(const Sampler &)            = delete;
+        Sampler &operator=(const Sampler &) = delete;
+
+        void bind(unsigned int unit) const;
+
+        [[nodiscard]] unsigned int get_handle() const noexcept;
+
+        [[nodiscard]] const SamplerDescription &get_description() const noexcept;
+
+      private:
+        unsigned int       m_Sampler;
+        SamplerDescription m_Description;
+    };
+
+    // Deduplicates sampler objects by description, so any number of textures sampled the same way share one GL sampler. Cached samplers live as
+    // long as the cache (i.e. the thread owning the context).
+    class SamplerCache {
+      public:
+        static SamplerCache &get();
+
+        std::shared_ptr<const Sampler> get_sampler(const SamplerDescription &description);
+
+        [[nodiscard]] float get_max_anisotropy();
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_Samplers.size(); }
+
+        void clear();
+
+      private:
+        struct DescriptionHash {
+            std::size_t operator()(const SamplerDescription &description) const noexcept { return description.hash(); }
+        };
+
+        std::unordered_map<SamplerDescription, std::shared_ptr<const Sampler>, DescriptionHash> m_Samplers;
+        std::optional<float>                                                                  m_MaxAnisotropy;
+    };
+} // namespace game::render
@@ -0,0 +1,379 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/state_cache.hpp"
+
+#include <algorithm>
+
+namespace game::render {
+    namespace {
+        void set_capability(const GLenum capability, const bool enabled) {
+            if (enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+        }
+    } // namespace
+
+    StateCache &StateCache::get() {
+        thread_local StateCache cache;
+        return cache;
+    }
+
+    template <typename T>
+    bool StateCache::update(T &current, const T &desired) {
+        if (current == desired) {
+            m_Statistics.skipped++;
+            return false;
+        }
+
+        current = desired;
+        m_Statistics.issued++;
+        return true;
+    }
+
+    void StateCache::use_program(const unsigned int program) {
+        if (update(m_Program, program)) {
+            m_Pipeline = unknown;
+            glUseProgram(program);
+        }
+    }
+
+    void StateCache::bind_vertex_array(const unsigned int vertex_array) {
+        if (update(m_VertexArray, vertex_array)) {
+            glBindVertexArray(vertex_array);
+        }
+    }
+
+    void StateCache::bind_framebuffer(const GLenum target, const unsigned int framebuffer) {
+        switch (target) {
+        case GL_DRAW_FRAMEBUFFER:
+            if (update(m_DrawFramebuffer, framebuffer)) {
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+            }
+            break;
+        case GL_READ_FRAMEBUFFER:
+            if (update(m_ReadFramebuffer, framebuffer)) {
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+            }
+            break;
+        default:
+            if (m_DrawFramebuffer == framebuffer && m_ReadFramebuffer == framebuffer) {
+                m_Statistics.skipped++;
+                break;
+            }
+
+            m_DrawFramebuffer = framebuffer;
+            m_ReadFramebuffer = framebuffer;
+            m_Statistics.issued++;
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            break;
+        }
+    }
+
+    void StateCache::bind_texture(const unsigned int unit, const unsigned int texture) {
+        if (m_Textures.size() <= unit) {
+            m_Textures.resize(unit + 1, unknown);
+        }
+
+        if (update(m_Textures[unit], texture)) {
+            glBindTextureUnit(unit, texture);
+        }
+    }
+
+    void StateCache::bind_sampler(const unsigned int unit, const unsigned int sampler) {
+        if (m_Samplers.size() <= unit) {
+            m_Samplers.resize(unit + 1, unknown);
+        }
+
+        if (update(m_Samplers[unit], sampler)) {
+            glBindSampler(unit, sampler);
+        }
+    }
+
+    void StateCache::update_range(std::vector<unsigned int>          &current,
+                                  const unsigned int                  first,
+                                  const std::span<const unsigned int> desired,
+                                  void (*const bind)(GLuint, GLsizei, const GLuint *)) {
+        if (desired.empty()) {
+            return;
+        }
+
+        if (current.size() < first + desired.size()) {
+            current.resize(first + desired.size(), unknown);
+        }
+
+        std::size_t begin = 0;
+        std::size_t end   = desired.size();
+        while (begin < end && current[first + begin] == desired[begin]) {
+            begin++;
+        }
+        while (end > begin && current[first + end - 1] == desired[end - 1]) {
+            end--;
+        }
+
+        if (begin == end) {
+            m_Statistics.skipped++;
+            return;
+        }
+
+        std::ranges::copy(desired.subspan(begin, end - begin), current.begin() + first + begin);
+        m_Statistics.issued++;
+        bind(static_cast<GLuint>(first + begin), static_cast<GLsizei>(end - begin), desired.data() + begin);
+    }
+
+    void StateCache::bind_textures(const unsigned int first, const std::span<const unsigned int> textures) {
+        update_range(m_Textures, first, textures, [](const GLuint f, const GLsizei count, const GLuint *names) { glBindTextures(f, count, names); });
+    }
+
+    void StateCache::bind_samplers(const unsigned int first, const std::span<const unsigned int> samplers) {
+        update_range(m_Samplers, first, samplers, [](const GLuint f, const GLsizei count, const GLuint *names) { glBindSamplers(f, count, names); });
+    }
+
+    void StateCache::bind_image(const unsigned int unit,
+                                const unsigned int texture,
+                                const int          level,
+                                const bool         layered,
+                                const int          layer,
+                                const GLenum       access,
+                                const GLenum       format) {
+        if (m_Images.size() <= unit) {
+            m_Images.resize(unit + 1);
+        }
+
+        if (update(m_Images[unit], {texture, level, layered, layer, access, format})) {
+            glBindImageTexture(unit, texture, level, layered, layer, access, format);
+        }
+    }
+
+    void StateCache::bind_buffer(const GLenum target, const unsigned int buffer) {
+        // the element array binding is part of the vertex array state, so it can't be shadowed independently
+        if (target == GL_ELEMENT_ARRAY_BUFFER) {
+            m_Statistics.issued++;
+            glBindBuffer(target, buffer);
+            return;
+        }
+
+        const auto [it, inserted] = m_Buffers.try_emplace(target, unknown);
+        if (update(it->second, buffer)) {
+            glBindBuffer(target, buffer);
+        }
+    }
+
+    void StateCache::bind_buffer_range(
+        const GLenum target, const unsigned int index, const unsigned int buffer, const std::size_t offset, const std::size_t size) {
+        const auto [it, inserted] = m_BufferRanges.try_emplace({target, index});
+        if (!update(it->second, {buffer, offset, size})) {
+            return;
+        }
+
+        if (size == 0) {
+            glBindBufferBase(target, index, buffer);
+        } else {
+            glBindBufferRange(target, index, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+        }
+
+        // binding an indexed target also replaces its generic binding
+        m_Buffers[target] = buffer;
+    }
+
+    void StateCache::set_blend_state(const BlendState &state) {
+        if (m_BlendStateKnown && m_BlendState == state) {
+            m_Statistics.skipped++;
+            return;
+        }
+
+        if (!m_BlendStateKnown || m_BlendState.enabled != state.enabled) {
+            set_capability(GL_BLEND, state.enabled);
+        }
+
+        if (!m_BlendStateKnown || m_BlendState.src_color != state.src_color || m_BlendState.dst_color != state.dst_color ||
+            m_BlendState.src_alpha != state.src_alpha || m_BlendState.dst_alpha != state.dst_alpha) {
+            glBlendFuncSeparate(static_cast<GLenum>(state.src_color),
+                                static_cast<GLenum>(state.dst_color),
+                                static_cast<GLenum>(state.src_alpha),
+                                static_cast<GLenum>(state.dst_alpha));
+        }
+
+        if (!m_BlendStateKnown || m_BlendState.color_op != state.color_op || m_BlendState.alpha_op != state.alpha_op) {
+            glBlendEquationSeparate(static_cast<GLenum>(state.color_op), static_cast<GLenum>(state.alpha_op));
+        }
+
+        m_BlendState      = state;
+        m_BlendStateKnown = true;
+        m_Pipeline        = unknown;
+        m_Statistics.issued++;
+    }
+
+    void StateCache::set_depth_state(const DepthState &state) {
+        if (m_DepthStateKnown && m_DepthState == state) {
+            m_Statistics.skipped++;
+            return;
+        }
+
+        if (!m_DepthStateKnown || m_DepthState.test != state.test) {
+            set_capability(GL_DEPTH_TEST, state.test);
+        }
+
+        if (!m_DepthStateKnown || m_DepthState.write != state.write) {
+            glDepthMask(state.write);
+        }
+
+        if (!m_DepthStateKnown || m_DepthState.compare != state.compare) {
+            glDepthFunc(static_cast<GLenum>(state.compare));
+        }
+
+        m_DepthState      = state;
+        m_DepthStateKnown = true;
+        m_Pipeline        = unknown;
+        m_Statistics.issued++;
+    }
+
+    void StateCache::set_stencil_state(const StencilState &state) {
+        if (m_StencilStateKnown && m_StencilState == state) {
+            m_Statistics.skipped++;
+            return;
+        }
+
+        if (!m_StencilStateKnown || m_StencilState.test != state.test) {
+            set_capability(GL_STENCIL_TEST, state.test);
+        }
+
+        if (!m_StencilStateKnown || m_StencilState.compare != state.compare || m_StencilState.reference != state.reference ||
+            m_StencilState.read_mask != state.read_mask) {
+            glStencilFunc(static_cast<GLenum>(state.compare), state.reference, state.read_mask);
+        }
+
+        if (!m_StencilStateKnown || m_StencilState.write_mask != state.write_mask) {
+            glStencilMask(state.write_mask);
+        }
+
+        if (!m_StencilStateKnown || m_StencilState.fail != state.fail || m_StencilState.depth_fail != state.depth_fail ||
+            m_StencilState.pass != state.pass) {
+            glStencilOp(static_cast<GLenum>(state.fail), static_cast<GLenum>(state.depth_fail), static_cast<GLenum>(state.pass));
+        }
+
+        m_StencilState      = state;
+        m_StencilStateKnown = true;
+        m_Pipeline          = unknown;
+        m_Statistics.issued++;
+    }
+
+    void StateCache::set_rasterizer_state(const RasterizerState &state) {
+        if (m_RasterizerStateKnown && m_RasterizerState == state) {
+            m_Statistics.skipped++;
+            return;
+        }
+
+        if (!m_RasterizerStateKnown || m_RasterizerState.cull_mode != state.cull_mode) {
+            set_capability(GL_CULL_FACE, state.cull_mode != CullMode::None);
+            if (state.cull_mode != CullMode::None) {
+                glCullFace(static_cast<GLenum>(state.cull_mode));
+            }
+        }
+
+        if (!m_RasterizerStateKnown || m_RasterizerState.front_face != state.front_face) {
+            glFrontFace(static_cast<GLenum>(state.front_face));
+        }
+
+        if (!m_RasterizerStateKnown || m_RasterizerState.polygon_mode != state.polygon_mode) {
+            glPolygonMode(GL_FRONT_AND_BACK, static_cast<GLenum>(state.polygon_mode));
+        }
+
+        if (!m_RasterizerStateKnown || m_RasterizerState.scissor_test != state.scissor_test) {
+            set_capability(GL_SCISSOR_TEST, state.scissor_test);
+        }
+
+        m_RasterizerState      = state;
+        m_RasterizerStateKnown = true;
+        m_Pipeline             = unknown;
+        m_Statistics.issued++;
+    }
+
+    void StateCache::set_color_mask(const ColorMask &mask) {
+        if (m_ColorMaskKnown && m_ColorMask == mask) {
+            m_Statistics.skipped++;
+            return;
+        }
+
+        glColorMask(mask.r, mask.g, mask.b, mask.a);
+
+        m_ColorMask      = mask;
+        m_ColorMaskKnown = true;
+        m_Pipeline       = unknown;
+        m_Statistics.issued++;
+    }
+
+    void StateCache::on_program_deleted(const unsigned int program) {
+        // a program in use stays current after deletion, its name only becomes reusable once something else is used
+        if (m_Program == program) {
+            m_Program  = unknown;
+            m_Pipeline = unknown;
+        }
+    }
+
+    void StateCache::on_vertex_array_deleted(const unsigned int vertex_array) {
+        if (m_VertexArray == vertex_array) {
+            m_VertexArray = 0;
+        }
+    }
+
+    void StateCache::on_framebuffer_deleted(const unsigned int framebuffer) {
+        if (m_DrawFramebuffer == framebuffer) {
+            m_DrawFramebuffer = 0;
+        }
+        if (m_ReadFramebuffer == framebuffer) {
+            m_ReadFramebuffer = 0;
+        }
+    }
+
+    void StateCache::on_texture_deleted(const unsigned int texture) {
+        std::ranges::replace(m_Textures, texture, 0u);
+
+        // detaching from an image unit also resets the rest of that unit's binding, simplest to treat it as unknown
+        for (auto &image : m_Images) {
+            if (image.texture == texture) {
+                image.texture = unknown;
+            }
+        }
+    }
+
+    void StateCache::on_sampler_deleted(const unsigned int sampler) {
+        std::ranges::replace(m_Samplers, sampler, 0u);
+    }
+
+    void StateCache::on_buffer_deleted(const unsigned int buffer) {
+        for (auto &[target, bound] : m_Buffers) {
+            if (bound == buffer) {
+                bound = 0;
+            }
+        }
+
+        for (auto &[key, range] : m_BufferRanges) {
+            if (range.buffer == buffer) {
+                range.buffer = unknown;
+            }
+        }
+    }
+
+    void StateCache::invalidate() {
+        m_Program         = unknown;
+        m_VertexArray     = unknown;
+        m_DrawFramebuffer = unknown;
+        m_ReadFramebuffer = unknown;
+        m_Pipeline             = unknown;
+        m_BlendStateKnown      = false;
+        m_DepthStateKnown      = false;
+        m_StencilStateKnown    = false;
+        m_RasterizerStateKnown = false;
+        m_ColorMaskKnown       = false;
+
+        m_Textures.clear();
+        m_Samplers.clear();
+        m_Images.clear();
+        m_Buffers.clear();
+        m_BufferRanges.clear();
+    }
+} // namespace game::render
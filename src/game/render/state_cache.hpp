@@ -0,0 +1,260 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glad/gl.h>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace game::render {
+    enum class BlendFactor : GLenum {
+        Zero                  = GL_ZERO,
+        One                   = GL_ONE,
+        SrcColor              = GL_SRC_COLOR,
+        OneMinusSrcColor      = GL_ONE_MINUS_SRC_COLOR,
+        DstColor              = GL_DST_COLOR,
+        OneMinusDstColor      = GL_ONE_MINUS_DST_COLOR,
+        SrcAlpha              = GL_SRC_ALPHA,
+        OneMinusSrcAlpha      = GL_ONE_MINUS_SRC_ALPHA,
+        DstAlpha              = GL_DST_ALPHA,
+        OneMinusDstAlpha      = GL_ONE_MINUS_DST_ALPHA,
+        ConstantColor         = GL_CONSTANT_COLOR,
+        OneMinusConstantColor = GL_ONE_MINUS_CONSTANT_COLOR,
+        ConstantAlpha         = GL_CONSTANT_ALPHA,
+        OneMinusConstantAlpha = GL_ONE_MINUS_CONSTANT_ALPHA,
+        SrcAlphaSaturate      = GL_SRC_ALPHA_SATURATE,
+    };
+
+    enum class BlendOp : GLenum {
+        Add             = GL_FUNC_ADD,
+        Subtract        = GL_FUNC_SUBTRACT,
+        ReverseSubtract = GL_FUNC_REVERSE_SUBTRACT,
+        Min             = GL_MIN,
+        Max             = GL_MAX,
+    };
+
+    enum class CompareOp : GLenum {
+        Never        = GL_NEVER,
+        Less         = GL_LESS,
+        Equal        = GL_EQUAL,
+        LessEqual    = GL_LEQUAL,
+        Greater      = GL_GREATER,
+        NotEqual     = GL_NOTEQUAL,
+        GreaterEqual = GL_GEQUAL,
+        Always       = GL_ALWAYS,
+    };
+
+    enum class StencilOp : GLenum {
+        Keep          = GL_KEEP,
+        Zero          = GL_ZERO,
+        Replace       = GL_REPLACE,
+        Increment     = GL_INCR,
+        IncrementWrap = GL_INCR_WRAP,
+        Decrement     = GL_DECR,
+        DecrementWrap = GL_DECR_WRAP,
+        Invert        = GL_INVERT,
+    };
+
+    enum class CullMode : GLenum {
+        None         = GL_NONE,
+        Front        = GL_FRONT,
+        Back         = GL_BACK,
+        FrontAndBack = GL_FRONT_AND_BACK,
+    };
+
+    enum class FrontFace : GLenum {
+        CounterClockwise = GL_CCW,
+        Clockwise        = GL_CW,
+    };
+
+    enum class PolygonMode : GLenum {
+        Fill  = GL_FILL,
+        Line  = GL_LINE,
+        Point = GL_POINT,
+    };
+
+    struct BlendState {
+        bool        enabled   = false;
+        BlendFactor src_color = BlendFactor::One;
+        BlendFactor dst_color = BlendFactor::Zero;
+        BlendFactor src_alpha = BlendFactor::One;
+        BlendFactor dst_alpha = BlendFactor::Zero;
+        BlendOp     color_op  = BlendOp::Add;
+        BlendOp     alpha_op  = BlendOp::Add;
+
+        bool operator==(const BlendState &other) const = default;
+
+        static BlendState alpha_blending() {
+            return {true, BlendFactor::SrcAlpha, BlendFactor::OneMinusSrcAlpha, BlendFactor::SrcAlpha, BlendFactor::OneMinusSrcAlpha};
+        }
+    };
+
+    struct DepthState {
+        bool      test    = false;
+        bool      write   = true;
+        CompareOp compare = CompareOp::Less;
+
+        bool operator==(const DepthState &other) const = default;
+    };
+
+    // applies to front and back faces alike
+    struct StencilState {
+        bool         test       = false;
+        CompareOp    compare    = CompareOp::Always;
+        int          reference  = 0;
+        unsigned int read_mask  = 0xFF;
+        unsigned int write_mask = 0xFF;
+        StencilOp    fail       = StencilOp::Keep;
+        StencilOp    depth_fail = StencilOp::Keep;
+        StencilOp    pass       = StencilOp::Keep;
+
+        bool operator==(const StencilState &other) const = default;
+    };
+
+    struct RasterizerState {
+        CullMode    cull_mode    = CullMode::None;
+        FrontFace   front_face   = FrontFace::CounterClockwise;
+        PolygonMode polygon_mode = PolygonMode::Fill;
+        bool        scissor_test = false;
+
+        bool operator==(const RasterizerState &other) const = default;
+    };
+
+    struct ColorMask {
+        bool r = true, g = true, b = true, a = true;
+
+        bool operator==(const ColorMask &other) const = default;
+    };
+
+    // Shadows the binding and fixed-function state of the GL context current on the calling thread, so wrappers can skip calls that wouldn't
+    // change anything. Every wrapper binds through here; calling GL binding functions directly desynchronizes the cache (use invalidate() after
+    // doing so).
+    class StateCache {
+      public:
+        struct Statistics {
+            std::size_t issued;
+            std::size_t skipped;
+        };
+
+        static StateCache &get();
+
+        void use_program(unsigned int program);
+        void bind_vertex_array(unsigned int vertex_array);
+
+        // GL_FRAMEBUFFER binds both the draw and read framebuffer
+        void bind_framebuffer(GLenum target, unsigned int framebuffer);
+
+        void bind_texture(unsigned int unit, unsigned int texture);
+        void bind_sampler(unsigned int unit, unsigned int sampler);
+        // Binds consecutive units starting at `first` with a single glBindTextures/glBindSamplers call covering only the units that changed.
+        void bind_textures(unsigned int first, std::span<const unsigned int> textures);
+        void bind_samplers(unsigned int first, std::span<const unsigned int> samplers);
+
+        void bind_image(unsigned int unit, unsigned int texture, int level, bool layered, int layer, GLenum access, GLenum format);
+
+        void bind_buffer(GLenum target, unsigned int buffer);
+        // size == 0 binds the whole buffer (glBindBufferBase)
+        void bind_buffer_range(GLenum target, unsigned int index, unsigned int buffer, std::size_t offset, std::size_t size);
+
+        void set_blend_state(const BlendState &state);
+        void set_depth_state(const DepthState &state);
+        void set_stencil_state(const StencilState &state);
+        void set_rasterizer_state(const RasterizerState &state);
+        void set_color_mask(const ColorMask &mask);
+
+        // the last state set, or the defaults if none was
+        [[nodiscard]] const DepthState   &get_depth_state() const noexcept { return m_DepthState; }
+        [[nodiscard]] const StencilState &get_stencil_state() const noexcept { return m_StencilState; }
+        [[nodiscard]] const ColorMask    &get_color_mask() const noexcept { return m_ColorMask; }
+
+        // True while no program or fixed-function state changed since the pipeline with this id was bound, so binding it again can be skipped
+        // entirely. Any state change through the cache forgets the bound pipeline.
+        [[nodiscard]] bool is_pipeline_bound(std::uint32_t id) const noexcept { return m_Pipeline == id; }
+        // called by Pipeline::bind after applying its state
+        void set_bound_pipeline(std::uint32_t id) noexcept { m_Pipeline = id; }
+
+        // GL implicitly unbinds deleted objects from the current context, so the cache must forget them as well or it would skip rebinding a
+        // new object which got the same name.
+        void on_program_deleted(unsigned int program);
+        void on_vertex_array_deleted(unsigned int vertex_array);
+        void on_framebuffer_deleted(unsigned int framebuffer);
+        void on_texture_deleted(unsigned int texture);
+        void on_sampler_deleted(unsigned int sampler);
+        void on_buffer_deleted(unsigned int buffer);
+
+        // Forgets all shadowed state, so the next call of every kind is issued.
+        void invalidate();
+
+        [[nodiscard]] const Statistics &get_statistics() const noexcept { return m_Statistics; }
+
+        void reset_statistics() noexcept { m_Statistics = {}; }
+
+      private:
+        static constexpr unsigned int unknown = ~0u;
+
+        struct ImageBinding {
+            unsigned int texture = unknown;
+            int          level   = 0;
+            bool         layered = false;
+            int          layer   = 0;
+            GLenum       access  = GL_READ_ONLY;
+            GLenum       format  = GL_RGBA8;
+
+            bool operator==(const ImageBinding &other) const = default;
+        };
+
+        struct BufferRange {
+            unsigned int buffer = unknown;
+            std::size_t  offset = 0;
+            std::size_t  size   = 0;
+
+            bool operator==(const BufferRange &other) const = default;
+        };
+
+        struct IndexedTargetHash {
+            std::size_t operator()(const std::pair<GLenum, unsigned int> &key) const noexcept {
+                return std::hash<std::size_t>()(static_cast<std::size_t>(key.first) << 32 | key.second);
+            }
+        };
+
+        // returns true (and counts the call as issued) when `current` differs from `desired`, updating `current`
+        template <typename T>
+        bool update(T &current, const T &desired);
+
+        // shared diffing for the multi-bind calls, issues `bind(first, count, names)` for the smallest changed range
+        void update_range(std::vector<unsigned int> &current,
+                          unsigned int               first,
+                          std::span<const unsigned int> desired,
+                          void (*bind)(GLuint, GLsizei, const GLuint *));
+
+        unsigned int    m_Program              = unknown;
+        unsigned int    m_VertexArray          = unknown;
+        unsigned int    m_DrawFramebuffer      = unknown;
+        unsigned int    m_ReadFramebuffer      = unknown;
+        std::uint32_t   m_Pipeline             = unknown;
+        bool            m_BlendStateKnown      = false;
+        bool            m_DepthStateKnown      = false;
+        bool            m_StencilStateKnown    = false;
+        bool            m_RasterizerStateKnown = false;
+        bool            m_ColorMaskKnown       = false;
+        BlendState      m_BlendState           = {};
+        DepthState      m_DepthState           = {};
+        StencilState    m_StencilState         = {};
+        RasterizerState m_RasterizerState      = {};
+        ColorMask       m_ColorMask            = {};
+
+        std::vector<unsigned int> m_Textures;
+        std::vector<unsigned int> m_Samplers;
+        std::vector<ImageBinding> m_Images;
+
+        std::unordered_map<GLenum, unsigned int>                                             m_Buffers;
+        std::unordered_map<std::pair<GLenum, unsigned int>, BufferRange, IndexedTargetHash> m_BufferRanges;
+
+        Statistics m_Statistics {};
+    };
+} // namespace game::render
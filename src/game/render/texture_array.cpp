@@ -0,0 +1,106 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/texture_array.hpp"
+
+#include "game/asset_pack.hpp"
+#include "game/image/image_ops.hpp"
+#include "game/image/pixel_convert.hpp"
+
+#include <stdexcept>
+
+namespace game::render {
+    TextureArrayBuilder::TextureArrayBuilder(const unsigned int max_layers) : m_MaxLayers(max_layers) {}
+
+    ArrayLayer TextureArrayBuilder::add(const std::filesystem::path &path) {
+        if (path.extension() == ".dds") {
+            return add(image::load_dds(path));
+        }
+        return add(ImageData::load(path, 4));
+    }
+
+    ArrayLayer TextureArrayBuilder::add(const AssetPack &pack, const std::string_view path) {
+        const auto file = pack.get(path);
+        if (path.ends_with(".dds")) {
+            return add(image::parse_dds(file));
+        }
+        return add(ImageData::load_from_memory(file, 4));
+    }
+
+    ArrayLayer TextureArrayBuilder::add(ImageData image) {
+        if (image.pixel_type != PixelType::U8 || image.num_components < 1 || image.num_components > 4) {
+            throw std::invalid_argument("Texture arrays only hold 8-bit images with one to four channels");
+        }
+
+        if (image.num_components != 4) {
+            const std::size_t texels   = static_cast<std::size_t>(image.width) * image.height;
+            PooledBlock       expanded = allocate_pooled(texels * 4);
+            image::expand_to_rgba8(std::span(static_cast<const std::uint8_t *>(image.data.get()), texels * image.num_components),
+                                   image.num_components,
+                                   std::span(static_cast<std::uint8_t *>(expanded.get()), texels * 4));
+            image.data           = std::move(expanded);
+            image.num_components = 4;
+        }
+
+        ArrayLayer layer;
+        place(image.width, image.height, Format::RGBA8, 1, layer).images.push_back(std::move(image));
+        return layer;
+    }
+
+    ArrayLayer TextureArrayBuilder::add(image::CompressedImage image) {
+        ArrayLayer layer;
+        place(image.width, image.height, to_format(image.format), image.levels, layer).compressed.push_back(std::move(image));
+        return layer;
+    }
+
+    TextureArrayBuilder::Array &TextureArrayBuilder::place(
+        const unsigned int width, const unsigned int height, const Format format, const unsigned int levels, ArrayLayer &layer) {
+        // the newest array of a kind is the only one that can have room left
+        for (std::size_t i = m_Arrays.size(); i-- > 0;) {
+            Array &array = m_Arrays[i];
+            if (array.width == width && array.height == height && array.format == format && array.levels == levels) {
+                if (array.get_layer_count() >= m_MaxLayers) {
+                    break;
+                }
+                layer = {static_cast<unsigned int>(i), array.get_layer_count()};
+                return array;
+            }
+        }
+
+        layer = {static_cast<unsigned int>(m_Arrays.size()), 0};
+        return m_Arrays.emplace_back(Array {width, height, format, levels, {}, {}});
+    }
+
+    std::vector<std::shared_ptr<Texture>> TextureArrayBuilder::build(const bool mipmaps, const WrapMode wrap) {
+        std::vector<std::shared_ptr<Texture>> textures;
+        textures.reserve(m_Arrays.size());
+
+        for (const Array &array : m_Arrays) {
+            const bool         compressed = !array.compressed.empty();
+            const unsigned int levels     = compressed || !mipmaps ? array.levels : image::mip_level_count(array.width, array.height);
+
+            auto texture = std::make_shared<Texture>(Texture::Type::Texture2DArray);
+            texture->set_storage_2d_array(array.width, array.height, array.get_layer_count(), array.format, levels);
+            for (unsigned int layer = 0; layer < array.images.size(); layer++) {
+                texture->set_layer(layer, array.images[layer]);
+            }
+            for (unsigned int layer = 0; layer < array.compressed.size(); layer++) {
+                texture->set_layer(layer, array.compressed[layer].view());
+            }
+
+            if (levels > 1) {
+                if (!compressed) {
+                    texture->generate_mipmaps();
+                }
+                texture->set_sampler(SamplerDescription::trilinear(wrap));
+            } else {
+                texture->set_sampler(SamplerDescription::linear(wrap));
+            }
+            textures.push_back(std::move(texture));
+        }
+
+        m_Arrays.clear();
+        return textures;
+    }
+} // namespace game::render
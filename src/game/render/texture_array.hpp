@@ -0,0 +1,67 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/render/render.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace game::render {
+    // Where an image added to a TextureArrayBuilder ends up: the array it was grouped into and its layer there, the third coordinate of a
+    // sampler2DArray lookup.
+    struct ArrayLayer {
+        unsigned int array;
+        unsigned int layer;
+    };
+
+    // Groups same-sized, same-format images into 2D array textures, so a single binding covers all of them and draws that differ only in
+    // their image can be batched (or instanced, with the layer as a per-instance attribute). Unlike atlas regions, layers can tile and have
+    // mipmaps of their own. Images are collected first and uploaded by build(), as an array's layer count is fixed by its storage.
+    class TextureArrayBuilder {
+      public:
+        // Arrays are split once they reach `max_layers`; GL guarantees at least 2048.
+        explicit TextureArrayBuilder(unsigned int max_layers = 256);
+
+        TextureArrayBuilder(const TextureArrayBuilder &)            = delete;
+        TextureArrayBuilder &operator=(const TextureArrayBuilder &) = delete;
+
+        // DDS files stay compressed with the levels they hold, anything else is loaded as RGBA8.
+        ArrayLayer add(const std::filesystem::path &path);
+        ArrayLayer add(const AssetPack &pack, std::string_view path);
+        // Accepts 8-bit images with one to four channels, expanded to RGBA like GL would.
+        ArrayLayer add(ImageData image);
+        // Only grouped with images that have as many levels.
+        ArrayLayer add(image::CompressedImage image);
+
+        // Creates the textures, indexed by ArrayLayer::array, and empties the builder. With `mipmaps` uncompressed arrays get their chains
+        // generated on the GPU; compressed ones keep the levels of their images.
+        std::vector<std::shared_ptr<Texture>> build(bool mipmaps = true, WrapMode wrap = WrapMode::Repeat);
+
+        [[nodiscard]] std::size_t get_array_count() const noexcept { return m_Arrays.size(); }
+
+      private:
+        struct Array {
+            unsigned int width, height;
+            Format       format;
+            unsigned int levels; // of the source images, so 1 unless they're compressed
+
+            // one of these is empty
+            std::vector<ImageData>              images;
+            std::vector<image::CompressedImage> compressed;
+
+            [[nodiscard]] unsigned int get_layer_count() const noexcept {
+                return static_cast<unsigned int>(images.size() + compressed.size());
+            }
+        };
+
+        Array &place(unsigned int width, unsigned int height, Format format, unsigned int levels, ArrayLayer &layer);
+
+        unsigned int       m_MaxLayers;
+        std::vector<Array> m_Arrays;
+    };
+} // namespace game::render
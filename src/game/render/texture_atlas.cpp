@@ -0,0 +1,112 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/texture_atlas.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+
+namespace game::render {
+    TextureAtlas::TextureAtlas(const unsigned int page_size, const unsigned int padding) : m_PageSize(page_size), m_Padding(padding) {}
+
+    TextureAtlas::Page &TextureAtlas::add_page() {
+        auto texture = std::make_unique<Texture>(Texture::Type::Texture2D);
+        // a single level: mips of a packed page would blend neighbouring images together once the padding shrinks below a texel
+        texture->set_storage_2d(m_PageSize, m_PageSize, Format::RGBA8);
+        glClearTexImage(texture->get_handle(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        texture->set_sampler(SamplerDescription::linear(WrapMode::ClampToEdge));
+
+        m_Pages.push_back({std::move(texture), image::SkylinePacker(m_PageSize, m_PageSize)});
+        return m_Pages.back();
+    }
+
+    AtlasRegion TextureAtlas::add(const ImageData &image) {
+        if (image.pixel_type != PixelType::U8 || image.num_components < 1 || image.num_components > 4) {
+            throw std::invalid_argument("Texture atlases only hold 8-bit images with one to four channels");
+        }
+
+        const unsigned int width  = image.width + 2 * m_Padding;
+        const unsigned int height = image.height + 2 * m_Padding;
+        if (width > m_PageSize || height > m_PageSize) {
+            throw std::invalid_argument(std::format("A {}x{} image doesn't fit on a {}x{} atlas page", image.width, image.height, m_PageSize, m_PageSize));
+        }
+
+        std::optional<image::PackedRect> rect;
+        unsigned int                     page = 0;
+        for (; page < m_Pages.size(); page++) {
+            if ((rect = m_Pages[page].packer.insert(width, height))) {
+                break;
+            }
+        }
+        if (!rect) {
+            rect = add_page().packer.insert(width, height);
+        }
+
+        upload(m_Pages[page], *rect, image);
+        m_Regions++;
+
+        const unsigned int x     = rect->x + m_Padding;
+        const unsigned int y     = rect->y + m_Padding;
+        const auto         scale = 1.0f / static_cast<float>(m_PageSize);
+        return {page,
+                x,
+                y,
+                image.width,
+                image.height,
+                {static_cast<float>(x) * scale, static_cast<float>(y) * scale},
+                {static_cast<float>(x + image.width) * scale, static_cast<float>(y + image.height) * scale}};
+    }
+
+    void TextureAtlas::upload(const Page &page, const image::PackedRect &rect, const ImageData &image) const {
+        // build the padded tile on the CPU: clamping the source coordinates repeats the edge texels into the padding
+        std::vector<std::uint8_t> tile(static_cast<std::size_t>(rect.width) * rect.height * 4);
+        const auto               *source     = static_cast<const std::uint8_t *>(image.data.get());
+        const unsigned int        components = image.num_components;
+
+        for (unsigned int y = 0; y < rect.height; y++) {
+            const unsigned int  source_y = std::clamp<int>(static_cast<int>(y) - static_cast<int>(m_Padding), 0, static_cast<int>(image.height) - 1);
+            const std::uint8_t *row      = source + static_cast<std::size_t>(source_y) * image.width * components;
+
+            for (unsigned int x = 0; x < rect.width; x++) {
+                const unsigned int source_x = std::clamp<int>(static_cast<int>(x) - static_cast<int>(m_Padding), 0, static_cast<int>(image.width) - 1);
+                const std::uint8_t *texel    = row + static_cast<std::size_t>(source_x) * components;
+                std::uint8_t       *out      = tile.data() + (static_cast<std::size_t>(y) * rect.width + x) * 4;
+
+                // same expansion as uploading a GL_RED/GL_RG/GL_RGB image: missing color channels are zero, missing alpha is one
+                out[0] = texel[0];
+                out[1] = components >= 2 ? texel[1] : 0;
+                out[2] = components >= 3 ? texel[2] : 0;
+                out[3] = components == 4 ? texel[3] : 0xFF;
+            }
+        }
+
+        BarrierTracker::get().read(page.texture->get_resource(), BarrierTracker::Access::TextureUpdate);
+        glTextureSubImage2D(page.texture->get_handle(),
+                            0,
+                            static_cast<GLint>(rect.x),
+                            static_cast<GLint>(rect.y),
+                            static_cast<GLsizei>(rect.width),
+                            static_cast<GLsizei>(rect.height),
+                            GL_RGBA,
+                            GL_UNSIGNED_BYTE,
+                            tile.data());
+    }
+
+    const Texture *TextureAtlas::get_page(const unsigned int page) const {
+        if (page >= m_Pages.size()) {
+            throw std::out_of_range("Invalid atlas page");
+        }
+        return m_Pages[page].texture.get();
+    }
+
+    TextureAtlas::Statistics TextureAtlas::get_statistics() const noexcept {
+        float occupancy = 0.0f;
+        for (const auto &page : m_Pages) {
+            occupancy += page.packer.get_occupancy();
+        }
+        return {m_Pages.size(), m_Regions, m_Pages.empty() ? 0.0f : occupancy / static_cast<float>(m_Pages.size())};
+    }
+} // namespace game::render
@@ -0,0 +1,60 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/image/skyline_packer.hpp"
+#include "game/render/render.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace game::render {
+    struct AtlasRegion {
+        unsigned int page;
+        // texel rectangle of the image itself within the page, padding excluded
+        unsigned int x, y, width, height;
+        // texture coordinates of the same rectangle's outer edges
+        glm::vec2 uv_min, uv_max;
+    };
+
+    // Packs images into a growing set of RGBA8 page textures, so sprites from many images can share a texture (and a draw). Images can be
+    // added at any time. Each image is surrounded by `padding` texels repeating its edge texels, so linear filtering at its border doesn't
+    // pick up the neighbours.
+    class TextureAtlas {
+      public:
+        struct Statistics {
+            std::size_t pages;
+            std::size_t regions;
+            float       occupancy; // averaged over all pages
+        };
+
+        explicit TextureAtlas(unsigned int page_size = 2048, unsigned int padding = 2);
+
+        TextureAtlas(const TextureAtlas &)            = delete;
+        TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+        // Accepts 8-bit images with one to four channels (expanded to RGBA like GL would). Throws if the image can't fit on an empty page.
+        AtlasRegion add(const ImageData &image);
+
+        [[nodiscard]] const Texture *get_page(unsigned int page) const;
+        [[nodiscard]] std::size_t    get_page_count() const noexcept { return m_Pages.size(); }
+
+        [[nodiscard]] Statistics get_statistics() const noexcept;
+
+      private:
+        struct Page {
+            std::unique_ptr<Texture> texture;
+            image::SkylinePacker     packer;
+        };
+
+        Page &add_page();
+        void  upload(const Page &page, const image::PackedRect &rect, const ImageData &image) const;
+
+        unsigned int      m_PageSize;
+        unsigned int      m_Padding;
+        std::vector<Page> m_Pages;
+        std::size_t       m_Regions = 0;
+    };
+} // namespace game::render
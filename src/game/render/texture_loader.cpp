@@ -0,0 +1,370 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/texture_loader.hpp"
+#include "game/asset_pack.hpp"
+#include "game/image/image_ops.hpp"
+#include "game/image/pixel_convert.hpp"
+#include "game/image/qoi.hpp"
+#include "game/render/state_cache.hpp"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+namespace game::render {
+    namespace {
+        // textures show this until their data arrives, transparent so that nothing pops in as a solid block
+        constexpr std::uint8_t placeholder_texel[] = {0, 0, 0, 0};
+
+        // images are always decoded to RGBA8 so every row is 4-byte aligned and no unpack state needs changing
+        constexpr unsigned int channels = 4;
+
+        std::vector<std::uint8_t> read_file(const std::filesystem::path &path) {
+            std::ifstream f(path, std::ios::in | std::ios::binary | std::ios::ate);
+            if (!f) {
+                throw std::runtime_error(std::format("Failed to open {}", path.string()));
+            }
+
+            const std::streampos      end = f.tellg();
+            std::vector<std::uint8_t> file(static_cast<std::size_t>(end));
+            f.seekg(0, std::ios::beg);
+            f.read(reinterpret_cast<char *>(file.data()), end);
+            return file;
+        }
+    } // namespace
+
+    StagingRing::StagingRing(const std::size_t size) : m_Size(size) {
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glCreateBuffers(1, &m_Buffer);
+        glNamedBufferStorage(m_Buffer, static_cast<GLsizeiptr>(size), nullptr, flags);
+        m_Mapped = static_cast<std::byte *>(glMapNamedBufferRange(m_Buffer, 0, static_cast<GLsizeiptr>(size), flags));
+        if (m_Mapped == nullptr) {
+            glDeleteBuffers(1, &m_Buffer);
+            throw std::runtime_error("Failed to map staging buffer");
+        }
+    }
+
+    StagingRing::~StagingRing() {
+        glUnmapNamedBuffer(m_Buffer);
+        StateCache::get().on_buffer_deleted(m_Buffer);
+        glDeleteBuffers(1, &m_Buffer);
+    }
+
+    std::optional<StagingRing::Allocation> StagingRing::allocate(const std::size_t size, const std::size_t alignment) {
+        std::lock_guard lock(m_Mutex);
+
+        if (m_Regions.empty()) {
+            m_Head = 0;
+            m_Tail = 0;
+        } else if (m_Head == m_Tail) {
+            return std::nullopt; // full
+        }
+
+        const std::size_t aligned = (m_Head + alignment - 1) / alignment * alignment;
+        std::size_t       offset;
+        if (m_Head >= m_Tail) {
+            // free space is [head, size) followed by [0, tail)
+            if (aligned + size <= m_Size) {
+                offset = aligned;
+            } else if (size <= m_Tail) {
+                offset = 0;
+            } else {
+                return std::nullopt;
+            }
+        } else {
+            if (aligned + size > m_Tail) {
+                return std::nullopt;
+            }
+            offset = aligned;
+        }
+
+        const std::size_t end      = offset + size;
+        const std::size_t consumed = offset >= m_Head ? end - m_Head : m_Size - m_Head + end;
+        m_Head                     = end == m_Size ? 0 : end;
+        m_Used += consumed;
+        m_Regions.push_back({m_Head, consumed, false});
+
+        return Allocation {m_FirstId + m_Regions.size() - 1, offset, m_Mapped + offset};
+    }
+
+    void StagingRing::release(const std::uint64_t id) {
+        std::lock_guard lock(m_Mutex);
+
+        m_Regions[id - m_FirstId].released = true;
+        while (!m_Regions.empty() && m_Regions.front().released) {
+            m_Tail = m_Regions.front().end;
+            m_Used -= m_Regions.front().size;
+            m_Regions.pop_front();
+            m_FirstId++;
+        }
+    }
+
+    std::size_t StagingRing::get_bytes_in_use() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Used;
+    }
+
+    TextureLoader::TextureLoader(ThreadPool &pool, const std::size_t staging_size) : m_Pool(pool), m_Staging(staging_size) {}
+
+    TextureLoader::~TextureLoader() {
+        std::unique_lock lock(m_Mutex);
+        m_Idle.wait(lock, [this] { return m_Decoding == 0; });
+
+        for (const auto &in_flight : m_InFlight) {
+            glDeleteSync(in_flight.fence);
+        }
+    }
+
+    std::shared_ptr<Texture> TextureLoader::load(const std::filesystem::path &path, const bool mipmaps) {
+        auto texture = create_placeholder();
+        reload(texture, path, mipmaps);
+        return texture;
+    }
+
+    std::shared_ptr<Texture> TextureLoader::load(const AssetPack &pack, const std::string_view path, const bool mipmaps) {
+        auto texture = create_placeholder();
+        reload(texture, pack, path, mipmaps);
+        return texture;
+    }
+
+    void TextureLoader::reload(const std::shared_ptr<Texture> &texture, const std::filesystem::path &path, const bool mipmaps) {
+        start({.path = path, .mipmaps = mipmaps}, texture);
+    }
+
+    void TextureLoader::reload(const std::shared_ptr<Texture> &texture, const AssetPack &pack, const std::string_view path, const bool mipmaps) {
+        // looked up here so that a missing asset throws right away, like a missing file does with the other loaders
+        start({.path = path, .mipmaps = mipmaps, .encoded = pack.get(path)}, texture);
+    }
+
+    std::shared_ptr<Texture> TextureLoader::create_placeholder() {
+        auto texture = std::make_shared<Texture>(Texture::Type::Texture2D);
+        texture->set_image_2d(1, 1, Format::RGBA8, 1);
+        glTextureSubImage2D(texture->get_handle(), 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, placeholder_texel);
+        return texture;
+    }
+
+    void TextureLoader::start(Decoded decoded, const std::shared_ptr<Texture> &texture) {
+        m_Pending.insert(texture->get_handle());
+
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Decoding++;
+        }
+
+        decoded.texture = texture;
+        decoded.handle  = texture->get_handle();
+        m_Pool.submit([this, decoded = std::move(decoded)]() mutable { decode(std::move(decoded)); });
+    }
+
+    void TextureLoader::decode(Decoded decoded) {
+        try {
+            if (decoded.path.extension() == ".dds") {
+                decode_compressed(decoded);
+            } else {
+                decode_image(decoded);
+            }
+
+            // when the ring is full the pixels stay here and the GL thread copies them once there's room
+            stage(decoded);
+        } catch (...) {
+            decoded.error = std::current_exception();
+        }
+
+        std::lock_guard lock(m_Mutex);
+        m_Decoded.push_back(std::move(decoded));
+        m_Decoding--;
+        m_Idle.notify_all();
+    }
+
+    void TextureLoader::decode_image(Decoded &decoded) {
+        std::vector<std::uint8_t> file;
+        if (decoded.encoded.empty()) {
+            file = read_file(decoded.path);
+        }
+        const std::span<const std::uint8_t> encoded = decoded.encoded.empty() ? std::span<const std::uint8_t>(file) : decoded.encoded;
+
+        if (image::is_qoi(encoded)) {
+            // decoded straight into the chain, as RGBA and bottom row first
+            const image::QoiHeader header = image::parse_qoi_header(encoded);
+            decoded.width                 = header.width;
+            decoded.height                = header.height;
+            decoded.levels                = decoded.mipmaps ? image::mip_level_count(header.width, header.height) : 1;
+
+            decoded.pixels.resize(image::mip_chain_size_rgba8(header.width, header.height, decoded.levels));
+            image::decode_qoi(encoded, channels, decoded.pixels, true);
+        } else {
+            // decoded as stored, expanding to RGBA and flipping happen in a single pass while copying into the chain
+            const ImageData source = ImageData::load_from_memory(encoded, 0, false);
+            decoded.width          = source.width;
+            decoded.height         = source.height;
+            decoded.levels         = decoded.mipmaps ? image::mip_level_count(source.width, source.height) : 1;
+
+            decoded.pixels.resize(image::mip_chain_size_rgba8(source.width, source.height, decoded.levels));
+            const std::size_t source_row = static_cast<std::size_t>(source.width) * source.num_components;
+            const std::size_t row        = static_cast<std::size_t>(source.width) * channels;
+            for (unsigned int y = 0; y < source.height; y++) {
+                image::expand_to_rgba8(std::span(static_cast<const std::uint8_t *>(source.data.get()) + y * source_row, source_row),
+                                       source.num_components,
+                                       std::span(decoded.pixels).subspan((source.height - 1 - y) * row, row));
+            }
+        }
+
+        // built in ordinary memory: the staging buffer is likely write-combined, so reading earlier levels back from it would be slow
+        image::generate_mip_chain_rgba8(decoded.pixels, decoded.width, decoded.height, decoded.levels);
+    }
+
+    void TextureLoader::decode_compressed(Decoded &decoded) {
+        // already block-compressed and mipmapped offline, so there is nothing to do but read it
+        image::CompressedImageView view;
+        image::CompressedImage     compressed;
+        if (decoded.encoded.empty()) {
+            compressed = image::load_dds(decoded.path);
+            view       = compressed.view();
+        } else {
+            view           = image::parse_dds_view(decoded.encoded);
+            decoded.mapped = view.data;
+        }
+
+        decoded.width  = view.width;
+        decoded.height = view.height;
+        decoded.levels = view.levels;
+        decoded.format = to_format(view.format);
+        decoded.pixels = std::move(compressed.data);
+    }
+
+    void TextureLoader::update(const std::chrono::microseconds budget) {
+        const auto start = std::chrono::steady_clock::now();
+
+        retire_uploads();
+
+        while (true) {
+            Decoded decoded;
+            {
+                std::lock_guard lock(m_Mutex);
+                if (m_Decoded.empty()) {
+                    break;
+                }
+                decoded = std::move(m_Decoded.front());
+                m_Decoded.pop_front();
+            }
+
+            m_Pending.erase(m_Pending.find(decoded.handle));
+            if (decoded.error) {
+                // one broken asset shouldn't take the frame down with it; the texture just keeps showing the placeholder
+                try {
+                    std::rethrow_exception(decoded.error);
+                } catch (const std::exception &e) {
+                    spdlog::error("Failed to load texture {}: {}", decoded.path.string(), e.what());
+                }
+                m_Failed++;
+            } else {
+                upload(decoded);
+            }
+
+            if (std::chrono::steady_clock::now() - start >= budget) {
+                break;
+            }
+        }
+    }
+
+    void TextureLoader::stage(Decoded &decoded) {
+        const auto chain = decoded.get_chain();
+        if ((decoded.staging = m_Staging.allocate(chain.size()))) {
+            std::memcpy(decoded.staging->data, chain.data(), chain.size());
+            decoded.pixels = {};
+            decoded.mapped = {};
+        }
+    }
+
+    void TextureLoader::upload(Decoded &decoded) {
+        const auto texture = decoded.texture.lock();
+        if (!texture) {
+            // dropped before it finished loading
+            if (decoded.staging) {
+                m_Staging.release(decoded.staging->id);
+            }
+            return;
+        }
+
+        if (!decoded.staging) {
+            stage(decoded);
+        }
+
+        // respecifying the image must happen while no unpack buffer is bound, otherwise its null data pointer reads from the buffer
+        texture->set_image_2d(decoded.width, decoded.height, decoded.format, decoded.levels);
+
+        // without staging memory (the chain is larger than the whole ring) the upload comes straight from client memory
+        auto &cache = StateCache::get();
+        if (decoded.staging) {
+            cache.bind_buffer(GL_PIXEL_UNPACK_BUFFER, m_Staging.get_handle());
+        }
+
+        std::size_t offset = 0;
+        for (unsigned int level = 0; level < decoded.levels; level++) {
+            const unsigned int width  = image::mip_extent(decoded.width, level);
+            const unsigned int height = image::mip_extent(decoded.height, level);
+            const std::size_t  size   = image_size(decoded.format, width, height);
+            const void        *data   = decoded.staging ? reinterpret_cast<const void *>(decoded.staging->offset + offset)
+                                                        : static_cast<const void *>(decoded.get_chain().data() + offset);
+
+            if (is_compressed(decoded.format)) {
+                glCompressedTextureSubImage2D(texture->get_handle(),
+                                              static_cast<GLint>(level),
+                                              0,
+                                              0,
+                                              static_cast<GLsizei>(width),
+                                              static_cast<GLsizei>(height),
+                                              static_cast<GLenum>(decoded.format),
+                                              static_cast<GLsizei>(size),
+                                              data);
+            } else {
+                glTextureSubImage2D(texture->get_handle(),
+                                    static_cast<GLint>(level),
+                                    0,
+                                    0,
+                                    static_cast<GLsizei>(width),
+                                    static_cast<GLsizei>(height),
+                                    GL_RGBA,
+                                    GL_UNSIGNED_BYTE,
+                                    data);
+            }
+            offset += size;
+        }
+
+        if (decoded.staging) {
+            cache.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            m_InFlight.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), decoded.staging->id});
+        }
+
+        if (decoded.levels > 1) {
+            texture->set_sampler(SamplerDescription::trilinear(WrapMode::ClampToEdge));
+        }
+
+        m_Uploaded++;
+    }
+
+    void TextureLoader::retire_uploads() {
+        std::erase_if(m_InFlight, [this](const InFlight &in_flight) {
+            const GLenum status = glClientWaitSync(in_flight.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                return false;
+            }
+
+            glDeleteSync(in_flight.fence);
+            m_Staging.release(in_flight.staging_id);
+            return true;
+        });
+    }
+
+    bool TextureLoader::is_pending(const Texture &texture) const {
+        return m_Pending.contains(texture.get_handle());
+    }
+
+    TextureLoader::Statistics TextureLoader::get_statistics() const {
+        return {m_Pending.size(), m_Uploaded, m_Failed, m_Staging.get_bytes_in_use()};
+    }
+} // namespace game::render
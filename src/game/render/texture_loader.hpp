@@ -0,0 +1,164 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/render/render.hpp"
+#include "game/thread_pool.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace game::render {
+    // A persistently mapped pixel unpack buffer used as a ring of staging memory. Any thread may allocate and write into it; only the GL thread
+    // may create, release and destroy it. Allocations are retired in any order, the space is reused once everything allocated before it was
+    // released as well.
+    class StagingRing {
+      public:
+        struct Allocation {
+            std::uint64_t id;
+            std::size_t   offset;
+            std::byte    *data;
+        };
+
+        explicit StagingRing(std::size_t size);
+        ~StagingRing();
+
+        StagingRing(const StagingRing &)            = delete;
+        StagingRing &operator=(const StagingRing &) = delete;
+
+        // nullopt when there is no contiguous free range of that size right now
+        std::optional<Allocation> allocate(std::size_t size, std::size_t alignment = 16);
+        void                      release(std::uint64_t id);
+
+        [[nodiscard]] unsigned int get_handle() const noexcept { return m_Buffer; }
+        [[nodiscard]] std::size_t  get_size() const noexcept { return m_Size; }
+        [[nodiscard]] std::size_t  get_bytes_in_use() const;
+
+      private:
+        struct Region {
+            std::size_t end;
+            std::size_t size; // including alignment padding and space skipped when wrapping around
+            bool        released;
+        };
+
+        unsigned int m_Buffer;
+        std::byte   *m_Mapped;
+        std::size_t  m_Size;
+
+        mutable std::mutex m_Mutex;
+        std::size_t        m_Head = 0;
+        std::size_t        m_Tail = 0;
+        std::size_t        m_Used = 0;
+        std::deque<Region> m_Regions;
+        std::uint64_t      m_FirstId = 0;
+    };
+
+    // Loads textures without blocking the frame. load() returns a texture right away which shows a placeholder texel; decoding (and building
+    // the mip chain) runs on the thread pool and writes the pixels straight into staging memory, and update() (called once per frame on the GL thread) uploads finished
+    // images from there until its time budget is used up. The returned texture keeps its GL name throughout, so it can be bound and recorded
+    // into draws before its data arrived.
+    class TextureLoader {
+      public:
+        struct Statistics {
+            std::size_t pending;
+            std::size_t uploaded;
+            std::size_t failed; // logged, their textures keep the placeholder
+            std::size_t staging_bytes_in_use;
+        };
+
+        explicit TextureLoader(ThreadPool &pool, std::size_t staging_size = 32 * 1024 * 1024);
+        // waits for decodes still running on the pool
+        ~TextureLoader();
+
+        TextureLoader(const TextureLoader &)            = delete;
+        TextureLoader &operator=(const TextureLoader &) = delete;
+
+        // With `mipmaps` the full chain is built by the decoding worker and uploaded along with the image, and the texture gets a trilinear
+        // sampler once it arrives. DDS files stay compressed and come with the levels they contain.
+        std::shared_ptr<Texture> load(const std::filesystem::path &path, bool mipmaps = true);
+        // Decodes straight from the pack's mapping, and compressed images are copied from there right into staging memory. The pack must
+        // outlive the load.
+        std::shared_ptr<Texture> load(const AssetPack &pack, std::string_view path, bool mipmaps = true);
+
+        // Loads into an existing 2D texture, which keeps its current contents until the new ones are uploaded.
+        void reload(const std::shared_ptr<Texture> &texture, const std::filesystem::path &path, bool mipmaps = true);
+        void reload(const std::shared_ptr<Texture> &texture, const AssetPack &pack, std::string_view path, bool mipmaps = true);
+
+        // Uploads decoded images until `budget` is spent, always at least one if any is ready. Images which failed to decode are logged and
+        // counted in the statistics, their textures keeping the placeholder.
+        void update(std::chrono::microseconds budget);
+
+        [[nodiscard]] bool is_pending(const Texture &texture) const;
+
+        [[nodiscard]] Statistics get_statistics() const;
+
+      private:
+        struct Decoded {
+            std::weak_ptr<Texture>        texture;
+            unsigned int                  handle;
+            std::filesystem::path         path;
+            bool                          mipmaps;
+            // contents of the file when it comes from a pack, read from `path` otherwise
+            std::span<const std::uint8_t> encoded;
+
+            unsigned int width  = 0;
+            unsigned int height = 0;
+            unsigned int levels = 1;
+            Format       format = Format::RGBA8;
+            // the mip chain in `format`, levels packed one after another; emptied once copied into staging memory
+            std::vector<std::uint8_t>              pixels;
+            // the chain when it's uploaded from where it already is (a pack) rather than from `pixels`
+            std::span<const std::uint8_t>          mapped;
+            std::optional<StagingRing::Allocation> staging;
+            std::exception_ptr                     error;
+
+            [[nodiscard]] std::span<const std::uint8_t> get_chain() const {
+                return mapped.empty() ? std::span<const std::uint8_t>(pixels) : mapped;
+            }
+        };
+
+        struct InFlight {
+            GLsync        fence;
+            std::uint64_t staging_id;
+        };
+
+        static std::shared_ptr<Texture> create_placeholder();
+        void                            start(Decoded decoded, const std::shared_ptr<Texture> &texture);
+
+        void decode(Decoded decoded);
+        void decode_image(Decoded &decoded);
+        void decode_compressed(Decoded &decoded);
+        void stage(Decoded &decoded);
+        void upload(Decoded &decoded);
+        void retire_uploads();
+
+        ThreadPool &m_Pool;
+        StagingRing m_Staging;
+
+        std::mutex              m_Mutex;
+        std::condition_variable m_Idle;
+        std::deque<Decoded>     m_Decoded;
+        std::size_t             m_Decoding = 0;
+
+        // GL thread only
+        std::vector<InFlight> m_InFlight;
+        // a multiset, as the name of a texture dropped while loading may already be reused by another one being loaded
+        std::unordered_multiset<unsigned int> m_Pending;
+        std::size_t                           m_Uploaded = 0;
+        std::size_t                           m_Failed   = 0;
+    };
+} // namespace game::render
@@ -0,0 +1,149 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/render/texture_residency.hpp"
+#include "game/image/image_ops.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <vector>
+
+namespace game::render {
+    TextureResidency::TextureResidency(TextureLoader &loader, const std::size_t budget, const unsigned int tail_extent)
+        : m_Loader(loader), m_Budget(budget), m_TailExtent(tail_extent) {}
+
+    std::shared_ptr<Texture> TextureResidency::load(const std::filesystem::path &path) {
+        auto texture = m_Loader.load(path);
+        m_Entries[texture->get_handle()] = {.texture = texture, .path = path.string(), .last_used = m_Frame};
+        return texture;
+    }
+
+    std::shared_ptr<Texture> TextureResidency::load(const AssetPack &pack, const std::string_view path) {
+        auto texture = m_Loader.load(pack, path);
+        m_Entries[texture->get_handle()] = {.texture = texture, .pack = &pack, .path = std::string(path), .last_used = m_Frame};
+        return texture;
+    }
+
+    void TextureResidency::touch(const Texture &texture) {
+        if (const auto it = m_Entries.find(texture.get_handle()); it != m_Entries.end()) {
+            it->second.last_used = m_Frame;
+        }
+    }
+
+    unsigned int TextureResidency::droppable_levels(const Texture &texture) const {
+        unsigned int levels = 0;
+        while (levels + 1 < texture.get_levels() &&
+               std::max(image::mip_extent(texture.get_width(), levels), image::mip_extent(texture.get_height(), levels)) > m_TailExtent) {
+            levels++;
+        }
+        return levels;
+    }
+
+    void TextureResidency::update() {
+        std::size_t resident = 0;
+        for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+            const auto texture = it->second.texture.lock();
+            if (!texture) {
+                it = m_Entries.erase(it);
+                continue;
+            }
+
+            Entry &entry = it->second;
+            if (!m_Loader.is_pending(*texture)) {
+                // the initial load or a stream-in finished, the texture is complete now
+                if (entry.streaming || !entry.reduced) {
+                    entry.full_size = texture->get_memory_size();
+                    entry.reduced   = false;
+                    entry.streaming = false;
+                }
+            }
+
+            // a texture being streamed in is about to take its full size
+            resident += entry.streaming ? entry.full_size : texture->get_memory_size();
+            ++it;
+        }
+
+        evict(resident);
+        stream_in(resident);
+        m_Frame++;
+    }
+
+    void TextureResidency::evict(std::size_t &resident) {
+        if (resident <= m_Budget) {
+            return;
+        }
+
+        // textures used since the last update are on screen and only reduced if nothing else is left
+        std::vector<std::pair<Entry *, std::shared_ptr<Texture>>> candidates;
+        for (auto &entry : m_Entries | std::views::values) {
+            auto texture = entry.texture.lock();
+            if (texture && !entry.streaming && !m_Loader.is_pending(*texture) && droppable_levels(*texture) > 0) {
+                candidates.emplace_back(&entry, std::move(texture));
+            }
+        }
+        std::ranges::sort(candidates, {}, [](const auto &candidate) { return candidate.first->last_used; });
+
+        for (auto &[entry, texture] : candidates) {
+            if (resident <= m_Budget) {
+                break;
+            }
+
+            // drop as few levels as will do, each one roughly quartering the texture
+            const unsigned int droppable = droppable_levels(*texture);
+            const std::size_t  size      = texture->get_memory_size();
+            unsigned int       count     = 1;
+            for (; count < droppable; count++) {
+                std::size_t remaining = 0;
+                for (unsigned int level = count; level < texture->get_levels(); level++) {
+                    remaining += image_size(
+                        texture->get_format(), image::mip_extent(texture->get_width(), level), image::mip_extent(texture->get_height(), level));
+                }
+                if (resident - size + remaining <= m_Budget) {
+                    break;
+                }
+            }
+
+            texture->drop_top_levels(count);
+            resident = resident - size + texture->get_memory_size();
+
+            entry->reduced = true;
+            m_LevelsDropped += count;
+        }
+    }
+
+    void TextureResidency::stream_in(std::size_t &resident) {
+        for (auto &entry : m_Entries | std::views::values) {
+            if (!entry.reduced || entry.streaming || entry.last_used != m_Frame || entry.full_size == 0) {
+                continue;
+            }
+
+            const auto        texture = entry.texture.lock();
+            const std::size_t size    = texture->get_memory_size();
+            if (resident - size + entry.full_size > m_Budget) {
+                continue;
+            }
+
+            if (entry.pack != nullptr) {
+                m_Loader.reload(texture, *entry.pack, entry.path);
+            } else {
+                m_Loader.reload(texture, entry.path);
+            }
+
+            resident        = resident - size + entry.full_size;
+            entry.streaming = true;
+            m_StreamsStarted++;
+        }
+    }
+
+    TextureResidency::Statistics TextureResidency::get_statistics() const {
+        Statistics statistics {m_Entries.size(), 0, m_Budget, 0, m_LevelsDropped, m_StreamsStarted};
+        for (const auto &entry : m_Entries | std::views::values) {
+            if (const auto texture = entry.texture.lock()) {
+                statistics.resident_bytes += texture->get_memory_size();
+            }
+            statistics.textures_reduced += entry.reduced ? 1 : 0;
+        }
+        return statistics;
+    }
+} // namespace game::render
@@ -0,0 +1,85 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include "game/render/render.hpp"
+#include "game/render/texture_loader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace game::render {
+    // Keeps the textures loaded through it within a memory budget. Textures report when they're used with touch(); once per frame, update()
+    // shrinks the least recently used ones by dropping their largest mip levels until everything fits again, down to a small mip tail which
+    // always stays resident, so an evicted texture still shows a blurry version of itself instead of nothing. Textures touched while missing
+    // levels are streamed back in through the loader when the budget has room for them, keeping their low-res levels until the full chain
+    // arrives. Textures keep their GL names throughout, so shrinking and restoring them is invisible to whatever holds on to them.
+    class TextureResidency {
+      public:
+        struct Statistics {
+            std::size_t textures;
+            std::size_t resident_bytes;
+            std::size_t budget;
+            std::size_t textures_reduced; // currently missing levels
+            std::size_t levels_dropped;   // in total
+            std::size_t streams_started;  // in total
+        };
+
+        // Textures are reduced to the levels whose larger side is at most `tail_extent`, but never below that.
+        TextureResidency(TextureLoader &loader, std::size_t budget, unsigned int tail_extent = 64);
+
+        TextureResidency(const TextureResidency &)            = delete;
+        TextureResidency &operator=(const TextureResidency &) = delete;
+
+        // Always loaded with mipmaps, which are what eviction drops. The pack must outlive the residency manager.
+        std::shared_ptr<Texture> load(const std::filesystem::path &path);
+        std::shared_ptr<Texture> load(const AssetPack &pack, std::string_view path);
+
+        // Marks a texture loaded through this as used in the current frame; others are ignored.
+        void touch(const Texture &texture);
+
+        // Enforces the budget and starts streaming in used textures which are missing levels. Call once per frame, before the loader's update.
+        void update();
+
+        void                      set_budget(std::size_t budget) noexcept { m_Budget = budget; }
+        [[nodiscard]] std::size_t get_budget() const noexcept { return m_Budget; }
+
+        [[nodiscard]] Statistics get_statistics() const;
+
+      private:
+        struct Entry {
+            std::weak_ptr<Texture> texture;
+            const AssetPack       *pack = nullptr;
+            std::string            path;
+            std::uint64_t          last_used = 0;
+            // memory of the full chain, known once it was loaded completely
+            std::size_t full_size = 0;
+            bool        reduced   = false;
+            bool        streaming = false;
+        };
+
+        // levels of a texture above its mip tail
+        [[nodiscard]] unsigned int droppable_levels(const Texture &texture) const;
+
+        void evict(std::size_t &resident);
+        void stream_in(std::size_t &resident);
+
+        TextureLoader &m_Loader;
+        std::size_t    m_Budget;
+        unsigned int   m_TailExtent;
+
+        // by GL name
+        std::unordered_map<unsigned int, Entry> m_Entries;
+        std::uint64_t                           m_Frame = 1;
+
+        std::size_t m_LevelsDropped  = 0;
+        std::size_t m_StreamsStarted = 0;
+    };
+} // namespace game::render
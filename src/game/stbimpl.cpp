@@ -2,5 +2,12 @@
 // Created by andy on 2/18/2025.
 //
 
+#include "game/block_pool.hpp"
+
+// decode buffers come from the calling thread's block pool, so loading many images keeps reusing the same memory; ImageData adopts what stb
+// returns as a PooledBlock
+#define STBI_MALLOC(size)         game::pooled_malloc(size)
+#define STBI_REALLOC(block, size) game::pooled_realloc(block, size)
+#define STBI_FREE(block)          game::pooled_free(block)
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
\ No newline at end of file
@@ -0,0 +1,88 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#include "game/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace game {
+    ThreadPool::ThreadPool(const unsigned int thread_count) {
+        m_Threads.reserve(thread_count);
+        for (unsigned int i = 0; i < thread_count; i++) {
+            m_Threads.emplace_back([this](const std::stop_token &stop_token) { worker(stop_token); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        for (auto &thread : m_Threads) {
+            thread.request_stop();
+        }
+        m_Condition.notify_all();
+        // workers drain the queue before noticing the stop request, and jthread joins them on destruction
+    }
+
+    unsigned int ThreadPool::default_thread_count() {
+        // hardware_concurrency is 0 when it can't be determined
+        return std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    void ThreadPool::parallel_for(const std::size_t count, const std::function<void(std::size_t)> &function) {
+        if (count == 0) {
+            return;
+        }
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(count - 1);
+        for (std::size_t i = 1; i < count; i++) {
+            futures.push_back(submit([&function, i] { function(i); }));
+        }
+
+        // the calling thread would only sit in wait otherwise
+        std::exception_ptr exception;
+        try {
+            function(0);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        for (auto &future : futures) {
+            try {
+                future.get();
+            } catch (...) {
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void ThreadPool::enqueue(std::function<void()> task) {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Tasks.push_back(std::move(task));
+        }
+        m_Condition.notify_one();
+    }
+
+    void ThreadPool::worker(const std::stop_token &stop_token) {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(m_Mutex);
+                if (!m_Condition.wait(lock, stop_token, [this] { return !m_Tasks.empty(); })) {
+                    return;
+                }
+
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+} // namespace game
@@ -0,0 +1,54 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace game {
+    // Fixed set of worker threads pulling tasks from a shared FIFO queue. Tasks must not touch the GL context.
+    class ThreadPool {
+      public:
+        // defaults to one thread per hardware thread, minus the one running the main loop
+        explicit ThreadPool(unsigned int thread_count = default_thread_count());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &)            = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        template <typename F>
+        std::future<std::invoke_result_t<F>> submit(F &&function) {
+            auto task   = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(function));
+            auto future = task->get_future();
+            enqueue([task] { (*task)(); });
+            return future;
+        }
+
+        // Runs function(0) ... function(count - 1) across the pool and the calling thread, returning once all of them finished. The first
+        // exception thrown by any of them is rethrown here. Must not be called from a task running on the same pool.
+        void parallel_for(std::size_t count, const std::function<void(std::size_t)> &function);
+
+        [[nodiscard]] std::size_t get_thread_count() const noexcept { return m_Threads.size(); }
+
+        static unsigned int default_thread_count();
+
+      private:
+        void enqueue(std::function<void()> task);
+        void worker(const std::stop_token &stop_token);
+
+        std::mutex                        m_Mutex;
+        std::condition_variable_any       m_Condition;
+        std::deque<std::function<void()>> m_Tasks;
+        std::vector<std::jthread>         m_Threads;
+    };
+} // namespace game
@@ -0,0 +1,247 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+// Converts source images into block-compressed, mipmapped DDS files, which Texture::load and TextureLoader upload without decoding anything.
+//
+// usage: asset_cooker [--format auto|bc1|bc3|bc4|bc5|qoi] [--srgb] [--premultiply] [--no-mips] [--force] <input> <output>
+//
+// A directory is cooked recursively, every image below it written to the same relative path below <output> with a .dds extension. Outputs
+// newer than their source are skipped unless --force is given. `auto` picks BC3 for images with any transparency and BC1 for the rest.
+// --premultiply multiplies colours by alpha before the mip chain is built, for textures drawn with premultiplied blending.
+//
+// `qoi` writes lossless .qoi files instead, for art that can't take block compression artifacts; those are decoded at load time, which
+// builds their mip chain, so --no-mips doesn't apply to them.
+
+#include "game/block_pool.hpp"
+#include "game/image/bc_encoder.hpp"
+#include "game/image/dds.hpp"
+#include "game/image/image_ops.hpp"
+#include "game/image/pixel_convert.hpp"
+#include "game/image/qoi.hpp"
+#include "game/thread_pool.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stb_image.h>
+#include <string_view>
+#include <vector>
+
+namespace {
+    struct Options {
+        std::optional<game::image::BlockFormat> format; // nullopt for auto
+        bool                                    srgb        = false;
+        bool                                    premultiply = false;
+        bool                                    mipmaps     = true;
+        bool                                    force       = false;
+        bool                                    qoi         = false;
+        std::filesystem::path                   input, output;
+    };
+
+    // block rows handed to a worker at once, enough that small levels don't turn into a flood of tiny tasks
+    constexpr unsigned int rows_per_task = 8;
+
+    Options parse_arguments(const int argc, char **argv) {
+        Options                            options;
+        std::vector<std::filesystem::path> paths;
+        for (int i = 1; i < argc; i++) {
+            const std::string_view argument = argv[i];
+            if (argument == "--srgb") {
+                options.srgb = true;
+            } else if (argument == "--premultiply") {
+                options.premultiply = true;
+            } else if (argument == "--no-mips") {
+                options.mipmaps = false;
+            } else if (argument == "--force") {
+                options.force = true;
+            } else if (argument == "--format" && i + 1 < argc) {
+                const std::string_view name = argv[++i];
+                if (name == "bc1") {
+                    options.format = game::image::BlockFormat::BC1;
+                } else if (name == "bc3") {
+                    options.format = game::image::BlockFormat::BC3;
+                } else if (name == "bc4") {
+                    options.format = game::image::BlockFormat::BC4;
+                } else if (name == "bc5") {
+                    options.format = game::image::BlockFormat::BC5;
+                } else if (name == "qoi") {
+                    options.qoi = true;
+                } else if (name != "auto") {
+                    throw std::invalid_argument(std::format("Unknown format {}", name));
+                }
+            } else if (argument.starts_with("--")) {
+                throw std::invalid_argument(std::format("Unknown option {}", argument));
+            } else {
+                paths.emplace_back(argument);
+            }
+        }
+
+        if (paths.size() != 2) {
+            throw std::invalid_argument(
+                "usage: asset_cooker [--format auto|bc1|bc3|bc4|bc5|qoi] [--srgb] [--premultiply] [--no-mips] [--force] <input> <output>");
+        }
+        options.input  = paths[0];
+        options.output = paths[1];
+        return options;
+    }
+
+    bool is_source_image(const std::filesystem::path &path) {
+        static constexpr std::string_view extensions[] = {".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".gif"};
+        return std::ranges::find(extensions, path.extension().string()) != std::end(extensions);
+    }
+
+    game::image::BlockFormat select_format(const Options &options, const std::span<const std::uint8_t> pixels) {
+        using game::image::BlockFormat;
+
+        BlockFormat format = options.format.value_or(BlockFormat::BC1);
+        if (!options.format) {
+            for (std::size_t i = 3; i < pixels.size(); i += 4) {
+                if (pixels[i] != 255) {
+                    format = BlockFormat::BC3;
+                    break;
+                }
+            }
+        }
+
+        if (options.srgb) {
+            if (format == BlockFormat::BC1) {
+                return BlockFormat::BC1_SRGB;
+            }
+            if (format == BlockFormat::BC3) {
+                return BlockFormat::BC3_SRGB;
+            }
+        }
+        return format;
+    }
+
+    void write_file(const std::filesystem::path &destination, const std::span<const std::uint8_t> file) {
+        std::filesystem::create_directories(destination.parent_path());
+        std::ofstream out(destination, std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out) {
+            throw std::runtime_error(std::format("Failed to write {}", destination.string()));
+        }
+    }
+
+    // QOI holds RGB or RGBA top row first, which is how stb hands the image over, so RGB images are written as they are
+    void cook_qoi(const Options               &options,
+                  const std::uint8_t          *data,
+                  const unsigned int           width,
+                  const unsigned int           height,
+                  const unsigned int           channels,
+                  const std::filesystem::path &source,
+                  const std::filesystem::path &destination) {
+        const std::size_t         texels = static_cast<std::size_t>(width) * height;
+        std::vector<std::uint8_t> expanded;
+        std::span                 pixels(data, texels * channels);
+        unsigned int              qoi_channels = 3;
+        if (channels != 3) {
+            expanded.resize(texels * 4);
+            game::image::expand_to_rgba8(pixels, channels, expanded);
+            if (options.premultiply) {
+                game::image::premultiply_alpha_rgba8(expanded);
+            }
+            pixels       = expanded;
+            qoi_channels = 4;
+        }
+
+        const std::vector<std::uint8_t> file = game::image::encode_qoi(pixels, width, height, qoi_channels, !options.srgb);
+        write_file(destination, file);
+
+        std::cout << std::format("{} -> {} ({}x{}, lossless, {} KiB)\n", source.string(), destination.string(), width, height, file.size() / 1024);
+    }
+
+    void cook(game::ThreadPool &pool, const Options &options, const std::filesystem::path &source, const std::filesystem::path &destination) {
+        if (!options.force && std::filesystem::exists(destination) &&
+            std::filesystem::last_write_time(destination) >= std::filesystem::last_write_time(source)) {
+            return;
+        }
+
+        // stb allocates through the thread's block pool, so each worker keeps reusing the same decode buffers
+        int                     w, h, nc;
+        const game::PooledBlock decoded(stbi_load(source.string().c_str(), &w, &h, &nc, 0));
+        if (decoded == nullptr) {
+            throw std::runtime_error(std::format("Failed to load {}: {}", source.string(), stbi_failure_reason()));
+        }
+
+        const auto width  = static_cast<unsigned int>(w);
+        const auto height = static_cast<unsigned int>(h);
+        if (options.qoi) {
+            cook_qoi(options, static_cast<const std::uint8_t *>(decoded.get()), width, height, static_cast<unsigned int>(nc), source, destination);
+            return;
+        }
+
+        const unsigned int levels = options.mipmaps ? game::image::mip_level_count(width, height) : 1;
+
+        // expanded to RGBA and flipped like ImageData::load does in one pass, since the rows of compressed images are uploaded as they're stored
+        std::vector<std::uint8_t> chain(game::image::mip_chain_size_rgba8(width, height, levels));
+        const auto                channels = static_cast<unsigned int>(nc);
+        const auto               *data     = static_cast<const std::uint8_t *>(decoded.get());
+        for (unsigned int y = 0; y < height; y++) {
+            game::image::expand_to_rgba8(std::span<const std::uint8_t>(data + static_cast<std::size_t>(y) * width * channels, width * channels),
+                                         channels,
+                                         std::span(chain).subspan(static_cast<std::size_t>(height - 1 - y) * width * 4, width * 4));
+        }
+
+        if (options.premultiply) {
+            game::image::premultiply_alpha_rgba8(std::span(chain).first(static_cast<std::size_t>(width) * height * 4));
+        }
+        game::image::generate_mip_chain_rgba8(chain, width, height, levels);
+
+        game::image::CompressedImage image {select_format(options, std::span(chain).first(static_cast<std::size_t>(width) * height * 4)),
+                                            width,
+                                            height,
+                                            levels,
+                                            {}};
+        image.data.resize(image.level_offset(levels));
+
+        std::size_t source_offset = 0;
+        for (unsigned int level = 0; level < levels; level++) {
+            const unsigned int level_width  = game::image::mip_extent(width, level);
+            const unsigned int level_height = game::image::mip_extent(height, level);
+            const std::size_t  source_size  = static_cast<std::size_t>(level_width) * level_height * 4;
+            const auto         level_source = std::span<const std::uint8_t>(chain).subspan(source_offset, source_size);
+            const auto         level_data   = std::span(image.data).subspan(image.level_offset(level), image.level_size(level));
+
+            const unsigned int rows = (level_height + 3) / 4;
+            pool.parallel_for((rows + rows_per_task - 1) / rows_per_task, [&](const std::size_t task) {
+                const auto first_row = static_cast<unsigned int>(task) * rows_per_task;
+                game::image::compress_rgba8_rows(image.format, level_source, level_width, level_height, level_data, first_row, rows_per_task);
+            });
+            source_offset += source_size;
+        }
+
+        const std::vector<std::uint8_t> file = game::image::write_dds(image);
+        write_file(destination, file);
+
+        std::cout << std::format(
+            "{} -> {} ({}x{}, {} levels, {} KiB)\n", source.string(), destination.string(), width, height, levels, file.size() / 1024);
+    }
+} // namespace
+
+int main(const int argc, char **argv) {
+    try {
+        const Options    options = parse_arguments(argc, argv);
+        game::ThreadPool pool;
+
+        if (std::filesystem::is_directory(options.input)) {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(options.input)) {
+                if (entry.is_regular_file() && is_source_image(entry.path())) {
+                    auto destination = options.output / std::filesystem::relative(entry.path(), options.input);
+                    destination.replace_extension(options.qoi ? ".qoi" : ".dds");
+                    cook(pool, options, entry.path(), destination);
+                }
+            }
+        } else {
+            cook(pool, options, options.input, options.output);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
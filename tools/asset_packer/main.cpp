@@ -0,0 +1,44 @@
+//
+// Created by andy on 10/19/2026.
+//
+
+// Packs every file below a directory into an asset pack, each under its path relative to that directory.
+//
+// usage: asset_packer <directory> <output>
+//
+// Typically run on the assets directory after asset_cooker wrote cooked textures into it, producing the assets.pack the game loads from
+// when it's present.
+
+#include "game/asset_pack.hpp"
+
+#include <format>
+#include <iostream>
+
+int main(const int argc, char **argv) {
+    try {
+        if (argc != 3) {
+            throw std::invalid_argument("usage: asset_packer <directory> <output>");
+        }
+
+        const std::filesystem::path directory = argv[1];
+        const std::filesystem::path output    = argv[2];
+
+        game::AssetPackWriter writer;
+        std::size_t           count = 0;
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(directory)) {
+            // the output may well be inside the directory being packed
+            if (entry.is_regular_file() && !(std::filesystem::exists(output) && std::filesystem::equivalent(entry.path(), output))) {
+                writer.add_file(std::filesystem::relative(entry.path(), directory).generic_string(), entry.path());
+                count++;
+            }
+        }
+
+        writer.write(output);
+        std::cout << std::format("packed {} assets into {}\n", count, output.string());
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}